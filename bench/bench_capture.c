@@ -0,0 +1,46 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "bsi_bench.h"
+#include "bsi_gpio_capture.h"
+
+#define BENCH_SAMPLES (1u << 26u)
+#define BENCH_RING    (1024u)
+
+static gpio_capture_entry_t g_bench_ring[BENCH_RING];
+
+/* One long burst per configuration, the host in_status holds still so the run-length ring only bumps its last count */
+static void _bench_capture(const char *pName, u16_t decimation, b_t rle)
+{
+    gpio_capture_t cap;
+    u32_t loads, stores;
+
+    gpio_capture_init(&cap, BS_GPIO_PORT_A, U16_V, g_bench_ring, BENCH_RING, decimation, rle);
+    bs_host_reg_count(NULL, NULL);
+    gpio_capture_run(&cap, 1024u);
+    bs_host_reg_count(&loads, &stores);
+
+    double start = bs_bench_now();
+    gpio_capture_run(&cap, BENCH_SAMPLES);
+    double ns = bs_bench_now() - start;
+
+    g_bs_bench_sink += cap.head;
+    printf("%-32s %8.1f Msamples/s %6.2f loads/sample\n", pName, (BENCH_SAMPLES * 1e3) / ns, loads / 1024.0);
+}
+
+int main(void)
+{
+    bs_host_gpio_reset();
+    bs_host_gpio_input(BS_GPIO_PORT_A, U16_V, 0x00A5u);
+    printf("bsi gpio capture, %u samples per burst\n", BENCH_SAMPLES);
+
+    _bench_capture("gpio_capture_run rle", 1u, TRUE);
+    _bench_capture("gpio_capture_run raw", 1u, FALSE);
+    _bench_capture("gpio_capture_run rle 1 of 4", 4u, TRUE);
+    _bench_capture("gpio_capture_run raw 1 of 4", 4u, FALSE);
+
+    return 0;
+}
@@ -0,0 +1,81 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "bsi_bench.h"
+#include "bsi_gpio_debounce.h"
+
+#define BENCH_SAMPLES (4096u)
+#define BENCH_ROUNDS  (2000u)
+
+/* The per-pin debounce the vertical counters replace, test_gpio_debounce checks that both agree on every sample */
+typedef struct {
+    u8_t count[BS_GPIO_PIN_NUM];
+    u16_t stable;
+    u8_t depth;
+} bench_debounce_pin_t;
+
+static u16_t g_bench_samples[BENCH_SAMPLES];
+
+static u16_t _bench_debounce_pin(bench_debounce_pin_t *pDeb, u16_t sample)
+{
+    for (u8_t pin = 0u; pin < BS_GPIO_PIN_NUM; pin++) {
+        if (!((sample ^ pDeb->stable) & SET_BIT(pin))) {
+            pDeb->count[pin] = 0u;
+        } else if (++pDeb->count[pin] >= pDeb->depth) {
+            pDeb->count[pin] = 0u;
+            pDeb->stable ^= (u16_t)SET_BIT(pin);
+        }
+    }
+    return pDeb->stable;
+}
+
+/* Every pin holds a level for a random while and bounces around each change, so both paths see flips and resets */
+static void _bench_samples(void)
+{
+    u32_t state = 0xC0FFEEu;
+    u16_t level = 0u;
+
+    for (u32_t i = 0u; i < BENCH_SAMPLES; i++) {
+        u32_t r = bs_bench_random(&state);
+        if (!(r & 0x3Fu)) {
+            level ^= (u16_t)(r >> 16u);
+        }
+        g_bench_samples[i] = level ^ ((r & 0xC0u) ? 0u : (u16_t)bs_bench_random(&state));
+    }
+}
+
+int main(void)
+{
+    printf("bsi gpio debounce, %u samples per depth\n", BENCH_SAMPLES * BENCH_ROUNDS);
+    _bench_samples();
+
+    for (u8_t depth = 2u; depth <= 8u; depth *= 2u) {
+        gpio_debounce_t deb;
+        bench_debounce_pin_t pin = {.stable = 0u, .depth = depth};
+        char name[40];
+
+        gpio_debounce_init(&deb, 0u, depth);
+        double start = bs_bench_now();
+        for (u32_t round = 0u; round < BENCH_ROUNDS; round++) {
+            for (u32_t i = 0u; i < BENCH_SAMPLES; i++) {
+                g_bs_bench_sink += gpio_debounce_update(&deb, g_bench_samples[i]);
+            }
+        }
+        snprintf(name, sizeof(name), "gpio_debounce_update depth %u", depth);
+        printf("%-32s %8.1f ns/sample\n", name, (bs_bench_now() - start) / (BENCH_SAMPLES * BENCH_ROUNDS));
+
+        start = bs_bench_now();
+        for (u32_t round = 0u; round < BENCH_ROUNDS; round++) {
+            for (u32_t i = 0u; i < BENCH_SAMPLES; i++) {
+                g_bs_bench_sink += _bench_debounce_pin(&pin, g_bench_samples[i]);
+            }
+        }
+        snprintf(name, sizeof(name), "per-pin counters depth %u", depth);
+        printf("%-32s %8.1f ns/sample\n", name, (bs_bench_now() - start) / (BENCH_SAMPLES * BENCH_ROUNDS));
+    }
+
+    return 0;
+}
@@ -0,0 +1,29 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "bsi_bench.h"
+
+int main(void)
+{
+    gpio_ctrl_1_t out = GPIO_CTRL_1_VAL(CTRL_OUTPUT, CTRL_OPEN_DRAIN, CTRL_SPEED_LEVEL_3, CTRL_PULL_UP, CTRL_HIGH, CTRL_AF_FUNC_5);
+    gpio_ctrl_1_t settings[BS_GPIO_PIN_NUM];
+    gpio_ctrl_1_t afio = GPIO_CTRL_1_VAL(CTRL_AFIO, CTRL_PUSH_PULL, CTRL_SPEED_LEVEL_1, CTRL_PULL_DOWN, CTRL_LOW, CTRL_AF_FUNC_10);
+
+    bs_host_gpio_reset();
+    printf("bsi gpio, BS_GPIO_FIELD_ENGINE_ENABLED=%u, %u calls per entry point\n", BS_GPIO_FIELD_ENGINE_ENABLED, BS_BENCH_ITERATIONS);
+
+    BS_BENCH_RUN("gpio_ctrl_1_set", gpio_ctrl_1_set(BS_GPIO_NUM(BS_GPIO_PORT_A, i & 15u), (i & 16u) ? out : afio));
+    BS_BENCH_RUN("gpio_ctrl_1_set_mask 16 pins", gpio_ctrl_1_set_mask(BS_GPIO_PORT_A, U16_V, (i & 1u) ? out : afio));
+    BS_BENCH_RUN("gpio_ctrl_1_apply", gpio_ctrl_1_apply(BS_GPIO_NUM(BS_GPIO_PORT_B, 3u), out, NULL));
+    BS_BENCH_RUN("gpio_ctrl_1_get", gpio_ctrl_1_get(BS_GPIO_NUM(BS_GPIO_PORT_A, i & 15u), &settings[0]));
+    BS_BENCH_RUN("gpio_port_decode", gpio_port_decode(BS_GPIO_PORT_A, settings));
+    BS_BENCH_RUN("gpio_base_regs_addr", g_bs_bench_sink += (u32_t)gpio_base_regs_addr((u8_t)(g_bs_bench_index + (i % 3u))));
+    BS_BENCH_RUN("gpio_write", gpio_write(BS_GPIO_NUM(BS_GPIO_PORT_A, i & 15u), (b_t)(i & 1u)));
+    BS_BENCH_RUN("gpio_toggle", gpio_toggle(BS_GPIO_NUM(BS_GPIO_PORT_A, 5u)));
+    BS_BENCH_RUN("gpio_port_read", g_bs_bench_sink += gpio_port_read(BS_GPIO_PORT_A));
+
+    return 0;
+}
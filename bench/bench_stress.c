@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include <pthread.h>
+#include "bsi_bench.h"
+
+#define BENCH_THREADS_MAX (4u)
+#define BENCH_CALLS       (BS_BENCH_ITERATIONS / 4u)
+
+static const gpio_ctrl_1_t g_bench_settings[2] = {
+    GPIO_CTRL_1_VAL(CTRL_OUTPUT, CTRL_PUSH_PULL, CTRL_SPEED_LEVEL_2, CTRL_FLOAT, CTRL_HIGH, CTRL_AF_FUNC_0),
+    GPIO_CTRL_1_VAL(CTRL_INPUT, CTRL_PUSH_PULL, CTRL_SPEED_LEVEL_0, CTRL_PULL_UP, CTRL_LOW, CTRL_AF_FUNC_0),
+};
+
+/* The setting each read back has to return, the decode folds the encodings a family cannot tell apart */
+static gpio_ctrl_1_t g_bench_expect[2];
+static u32_t g_bench_threads;
+static u32_t g_bench_lost;
+
+/* The setting last written to each pin of port A, every pin has exactly one writer */
+static u8_t g_bench_last[BS_GPIO_PIN_NUM];
+
+/* Alternate the setting of the pins one thread owns and read each one back, all threads share the registers of port A */
+static void *_bench_worker(void *pArg)
+{
+    u32_t pins = BS_GPIO_PIN_NUM / g_bench_threads;
+    u32_t first = (u32_t)(uptr_t)pArg * pins;
+    u32_t state = 0x9E3779B9u ^ first;
+    u32_t lost = 0u;
+
+    for (u32_t i = 0u; i < BENCH_CALLS; i++) {
+        u32_t r = bs_bench_random(&state);
+        gpio_num_t port_pin = BS_GPIO_NUM(BS_GPIO_PORT_A, first + (r % pins));
+        u8_t k = (u8_t)((r >> 8u) & 1u);
+        gpio_ctrl_1_t setting;
+
+        gpio_ctrl_1_set(port_pin, g_bench_settings[k]);
+        gpio_ctrl_1_get(port_pin, &setting);
+        lost += (setting.value != g_bench_expect[k].value) ? 1u : 0u;
+        g_bench_last[BS_GPIO_PIN(port_pin)] = k;
+    }
+
+    __atomic_add_fetch(&g_bench_lost, lost, __ATOMIC_RELAXED);
+    return NULL;
+}
+
+/* Time the threads hammering one port, a read back not returning the setting just written is a lost update and a pin not holding
+ * its last setting once every thread is done is a stale one */
+static void _bench_stress(u32_t threads)
+{
+    pthread_t handles[BENCH_THREADS_MAX];
+    u32_t stale = 0u;
+    char name[40];
+
+    bs_host_gpio_reset();
+    for (u8_t k = 0u; k < 2u; k++) {
+        gpio_ctrl_1_set(BS_GPIO_NUM(BS_GPIO_PORT_B, 0u), g_bench_settings[k]);
+        gpio_ctrl_1_get(BS_GPIO_NUM(BS_GPIO_PORT_B, 0u), &g_bench_expect[k]);
+    }
+
+    g_bench_threads = threads;
+    g_bench_lost = 0u;
+    double start = bs_bench_now();
+    for (u32_t t = 0u; t < threads; t++) {
+        pthread_create(&handles[t], NULL, _bench_worker, (void *)(uptr_t)t);
+    }
+    for (u32_t t = 0u; t < threads; t++) {
+        pthread_join(handles[t], NULL);
+    }
+    double ns = bs_bench_now() - start;
+
+    for (gpio_pin_t pin = 0u; pin < BS_GPIO_PIN_NUM; pin++) {
+        gpio_ctrl_1_t setting;
+        gpio_ctrl_1_get(BS_GPIO_NUM(BS_GPIO_PORT_A, pin), &setting);
+        stale += (setting.value != g_bench_expect[g_bench_last[pin]].value) ? 1u : 0u;
+    }
+
+    snprintf(name, sizeof(name), "gpio_ctrl_1_set+get %u threads", threads);
+    printf("%-32s %8.1f ns/op %8u lost %2u stale\n", name, ns / ((double)BENCH_CALLS * threads), g_bench_lost, stale);
+}
+
+int main(void)
+{
+    printf("bsi gpio concurrent reconfiguration of port A, BS_GPIO_ATOMIC_ENABLED=%u, %u calls per thread\n", BS_GPIO_ATOMIC_ENABLED,
+           BENCH_CALLS);
+
+    for (u32_t threads = 1u; threads <= BENCH_THREADS_MAX; threads *= 2u) {
+        _bench_stress(threads);
+    }
+
+    return 0;
+}
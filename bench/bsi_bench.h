@@ -0,0 +1,67 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#ifndef _BSI_BENCH_H_
+#define _BSI_BENCH_H_
+
+#include <time.h>
+#include "bsi_host.h"
+
+/* The calls each benchmark times, enough to average out the clock resolution */
+#ifndef BS_BENCH_ITERATIONS
+#define BS_BENCH_ITERATIONS (2000000u)
+#endif
+
+/* Read through a volatile so the compiler neither hoists nor folds the argument of the timed call */
+static volatile u32_t g_bs_bench_index = 0u;
+static volatile u32_t g_bs_bench_sink = 0u;
+
+static inline double bs_bench_now(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((double)now.tv_sec * 1e9) + (double)now.tv_nsec;
+}
+
+/* A xorshift generator with a constant seed, every run feeds the benchmarks the same data */
+static inline u32_t bs_bench_random(u32_t *pState)
+{
+    u32_t x = *pState;
+
+    x ^= x << 13u;
+    x ^= x >> 17u;
+    x ^= x << 5u;
+    *pState = x;
+    return x;
+}
+
+static inline void bs_bench_report(const char *pName, double ns, u32_t loads, u32_t stores)
+{
+    printf("%-32s %8.1f ns/op %4u loads %4u stores\n", pName, ns, loads, stores);
+}
+
+/**
+ * Count the register accesses of the first call, then time the body over BS_BENCH_ITERATIONS calls. The body sees the loop counter
+ * as i, so a benchmark can walk the pins or alternate the settings.
+ */
+#define BS_BENCH_RUN(name, ...)                                                                                                            \
+    do {                                                                                                                                   \
+        u32_t loads_, stores_;                                                                                                             \
+        bs_host_reg_count(NULL, NULL);                                                                                                     \
+        {                                                                                                                                  \
+            u32_t i = 0u;                                                                                                                  \
+            __VA_ARGS__;                                                                                                                   \
+        }                                                                                                                                  \
+        bs_host_reg_count(&loads_, &stores_);                                                                                              \
+        double start_ = bs_bench_now();                                                                                                    \
+        for (u32_t i = 0u; i < BS_BENCH_ITERATIONS; i++) {                                                                                 \
+            __VA_ARGS__;                                                                                                                   \
+        }                                                                                                                                  \
+        bs_bench_report((name), (bs_bench_now() - start_) / BS_BENCH_ITERATIONS, loads_, stores_);                                         \
+    } while (0)
+
+#endif
@@ -8,7 +8,211 @@
 #define _BSI_CONFIGURATION_H_
 
 #include "typedef.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The silicon family selects the vendor headers, the register layout and the field encoder at compile time */
+#define BS_FAMILY_GD32W51X (1u)
+#define BS_FAMILY_GD32F30X (2u)
+
+#ifndef BS_FAMILY
+#define BS_FAMILY BS_FAMILY_GD32W51X
+#endif
+
+#if (BS_FAMILY != BS_FAMILY_GD32W51X) && (BS_FAMILY != BS_FAMILY_GD32F30X)
+#error "BS_FAMILY selects an unsupported silicon family"
+#endif
+
+/* The host build replaces the GPIO hardware by RAM-resident registers, see source/host/bsi_host.c */
+#if defined(BS_HOST_ENABLED)
+void bs_host_gpio_sync(u8_t inst);
+void bs_host_exti_sync(void);
+u32_t bs_host_timestamp(void);
+#define BS_GPIO_HOOK(inst) bs_host_gpio_sync(inst)
+#define BS_EXTI_HOOK()     bs_host_exti_sync()
+#else
+#if (BS_FAMILY == BS_FAMILY_GD32W51X)
+#include "gd32w51x_gpio.h"
+#include "gd32w51x_exti.h"
+#include "gd32w51x_syscfg.h"
+#else
 #include "gd32f30x_gpio.h"
+#include "gd32f30x_exti.h"
+#endif
+#define BS_GPIO_HOOK(inst) UNUSED_MSG(inst)
+#define BS_EXTI_HOOK()
+#endif
+
+/* The cycle timestamp of events, the DWT cycle counter on the Cortex-M targets */
+#ifndef BS_TIMESTAMP
+#if defined(BS_HOST_ENABLED)
+#define BS_TIMESTAMP() bs_host_timestamp()
+#else
+#define BS_TIMESTAMP() VREG32(0xE0001004u)
+#endif
+#endif
+
+/* Order the memory accesses between an ISR producer and a thread consumer */
+#if defined(BS_HOST_ENABLED)
+#define BS_MEMORY_BARRIER() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#elif defined(__CC_ARM)
+#define BS_MEMORY_BARRIER() __dmb(0xF)
+#elif defined(__ICCARM__)
+#include <intrinsics.h>
+#define BS_MEMORY_BARRIER() __DMB()
+#else
+#define BS_MEMORY_BARRIER() __asm volatile("dmb" ::: "memory")
+#endif
+
+/* Record every GPIO register store with its timestamp into a ring buffer, see bsi_gpio_trace.h */
+#ifndef BS_GPIO_TRACE_ENABLED
+#define BS_GPIO_TRACE_ENABLED (0u)
+#endif
+
+/* The number of trace entries kept, a power of 2 */
+#ifndef BS_GPIO_TRACE_SIZE
+#define BS_GPIO_TRACE_SIZE (64u)
+#endif
+
+/* The bus store, the host build applies the set, clear and toggle registers to out_ctrl at the store as the hardware does */
+#if defined(BS_HOST_ENABLED)
+u32_t bs_host_reg_store(vu32_t *pReg, u32_t value);
+#define BS_REG_BUS_STORE(reg, val) bs_host_reg_store(&(reg), (val))
+#else
+#define BS_REG_BUS_STORE(reg, val) ((reg) = (val))
+#endif
+
+#if BS_GPIO_TRACE_ENABLED
+void gpio_trace_record(uptr_t addr, u32_t value);
+
+static inline u32_t bs_reg_store(vu32_t *pReg, u32_t value)
+{
+    BS_REG_BUS_STORE(*pReg, value);
+    gpio_trace_record((uptr_t)pReg, value);
+    return value;
+}
+
+#define BS_REG_STORE(reg, val) bs_reg_store(&(reg), (val))
+#else
+#define BS_REG_STORE(reg, val) BS_REG_BUS_STORE(reg, val)
+#endif
+
+/* Every peripheral register load and store of the BSI layer goes through these, the host build counts them per call and per thread */
+#if defined(BS_HOST_ENABLED)
+extern __thread u32_t g_bs_host_reg_loads;
+extern __thread u32_t g_bs_host_reg_stores;
+#define BS_REG_RD(reg)      (g_bs_host_reg_loads++, __atomic_load_n(&(reg), __ATOMIC_RELAXED))
+#define BS_REG_WR(reg, val) (g_bs_host_reg_stores++, BS_REG_STORE(reg, val))
+#else
+#define BS_REG_RD(reg)      (reg)
+#define BS_REG_WR(reg, val) BS_REG_STORE(reg, val)
+#endif
+
+/* Update the masked fields of a register as one exclusive access so that concurrent updates of other fields are never lost */
+#ifndef BS_GPIO_ATOMIC_ENABLED
+#define BS_GPIO_ATOMIC_ENABLED (0u)
+#endif
+
+/**
+ * Merge value into the masked bits of the register and return the content found. The store is retried until no other access came in
+ * between, and skipped when the register already holds the merged content.
+ */
+static inline u32_t bs_reg_modify(vu32_t *pReg, u32_t mask, u32_t value)
+{
+    u32_t cur, next;
+
+#if defined(BS_HOST_ENABLED)
+    cur = __atomic_load_n(pReg, __ATOMIC_RELAXED);
+    do {
+        next = (cur & ~mask) | value;
+        if (next == cur) {
+            break;
+        }
+    } while (!__atomic_compare_exchange_n(pReg, &cur, next, TRUE, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED));
+    g_bs_host_reg_loads++;
+    if (next != cur) {
+        g_bs_host_reg_stores++;
+    }
+#elif defined(__CC_ARM)
+    do {
+        cur = __ldrex(pReg);
+        next = (cur & ~mask) | value;
+        if (next == cur) {
+            __clrex();
+            break;
+        }
+    } while (__strex(next, pReg));
+#elif defined(__ICCARM__)
+    do {
+        cur = __LDREX((unsigned long *)pReg);
+        next = (cur & ~mask) | value;
+        if (next == cur) {
+            __CLREX();
+            break;
+        }
+    } while (__STREX(next, (unsigned long *)pReg));
+#else
+    u32_t fail = 0u;
+    do {
+        __asm volatile("ldrex %0, [%1]" : "=r"(cur) : "r"(pReg) : "memory");
+        next = (cur & ~mask) | value;
+        if (next == cur) {
+            __asm volatile("clrex" ::: "memory");
+            break;
+        }
+        __asm volatile("strex %0, %2, [%1]" : "=&r"(fail) : "r"(pReg), "r"(next) : "memory");
+    } while (fail);
+#endif
+#if BS_GPIO_TRACE_ENABLED
+    if (next != cur) {
+        gpio_trace_record((uptr_t)pReg, next);
+    }
+#endif
+    return cur;
+}
+
+#if BS_GPIO_ATOMIC_ENABLED
+#define BS_REG_MODIFY(reg, mask, value) bs_reg_modify(&(reg), (mask), (value))
+#else
+#define BS_REG_MODIFY(reg, mask, value) BS_REG_WR(reg, (BS_REG_RD(reg) & ~(u32_t)(mask)) | (value))
+#endif
+
+/* The depth of the deferred EXTI event queue, a power of 2 */
+#ifndef BS_EXTI_QUEUE_SIZE
+#define BS_EXTI_QUEUE_SIZE (32u)
+#endif
+
+/* Keep a RAM shadow of the GPIO configuration registers so that reconfiguration never reads them back from the bus */
+#ifndef BS_GPIO_SHADOW_ENABLED
+#define BS_GPIO_SHADOW_ENABLED (0u)
+#endif
+
+/* The shadow and the register are two stores, which no exclusive access can cover together */
+#if BS_GPIO_SHADOW_ENABLED && BS_GPIO_ATOMIC_ENABLED
+#error "BS_GPIO_ATOMIC_ENABLED cannot be combined with BS_GPIO_SHADOW_ENABLED"
+#endif
+
+/* Encode the GPIO settings through the field engine of bsi_field.h, a size build trading call time for code, GD32W51x only */
+#ifndef BS_GPIO_FIELD_ENGINE_ENABLED
+#define BS_GPIO_FIELD_ENGINE_ENABLED (0u)
+#endif
+
+/* Record the GPIO configuration written through the BSI layer and let gpio_verify_step check the hardware against it */
+#ifndef BS_GPIO_VERIFY_ENABLED
+#define BS_GPIO_VERIFY_ENABLED (0u)
+#endif
+
+/* The number of drivers able to claim GPIO pins, see bsi_gpio_owner.h */
+#ifndef BS_GPIO_OWNER_NUM
+#define BS_GPIO_OWNER_NUM (8u)
+#endif
+
+/* Reject configuring a pin no driver claimed, a debug aid costing one check per configuration call */
+#ifndef BS_GPIO_OWNER_CHECK_ENABLED
+#define BS_GPIO_OWNER_CHECK_ENABLED (0u)
+#endif
 
 enum {
     BS_GPIO_PORT_A = (0u),
@@ -17,6 +221,18 @@ enum {
     BS_GPIO_PORT_NUM,
 };
 
+/* The port base addresses in port order, kept a constant list so that the typed pin handles fold them */
+#if !defined(BS_HOST_ENABLED)
+#define BS_GPIO_BASE_ADDRS {GPIOA, GPIOB, GPIOC}
+
+/* The EXTI source selection registers, SYSCFG_EXTISS0..3 on the GD32W51x and AFIO_EXTISS0..3 on the GD32F30x */
+#if (BS_FAMILY == BS_FAMILY_GD32W51X)
+#define BS_EXTI_SEL_BASE_ADDR (SYSCFG + 0x08u)
+#else
+#define BS_EXTI_SEL_BASE_ADDR (AFIO + 0x08u)
+#endif
+#endif
+
 enum {
     BS_GPIO_PIN_0 = (0u),
     BS_GPIO_PIN_1,
@@ -38,16 +254,34 @@ enum {
     BS_GPIO_PIN_NUM,
 };
 
-static inline vu32_t gpio_base_regs_addr(u8_t inst)
+static inline uptr_t gpio_base_regs_addr(u8_t inst)
 {
-    extern vu32_t g_gpio_base_regs[];
+    extern const uptr_t g_gpio_base_regs[];
 
     if (inst >= BS_GPIO_PORT_NUM) {
-        return NULL;
+        return 0u;
     }
     return g_gpio_base_regs[inst];
 }
 
+static inline uptr_t exti_base_regs_addr(void)
+{
+    extern const uptr_t g_exti_base_regs;
+
+    return g_exti_base_regs;
+}
+
+static inline uptr_t exti_sel_regs_addr(void)
+{
+    extern const uptr_t g_exti_sel_regs;
+
+    return g_exti_sel_regs;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif
 
 
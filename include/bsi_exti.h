@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#ifndef _BSI_EXTI_H_
+#define _BSI_EXTI_H_
+
+#include "bsi_gpio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The EXTI lines 0..15 follow the pin number, exti_register routes the port onto the line through the source selection. The board
+ * enables the SYSCFG clock on the GD32W51x, the AFIO clock on the GD32F30x */
+#define BS_EXTI_LINE_NUM (BS_GPIO_PIN_NUM)
+
+/* The source selection takes 4 bits per line, four lines per register, and numbers the ports as gpio_port_t does */
+#define BS_EXTI_SEL_LINES (4u)
+#define BS_EXTI_SEL_WIDTH (4u)
+
+enum {
+    EXTI_EDGE_RISING = (1u),
+    EXTI_EDGE_FALLING = (2u),
+    EXTI_EDGE_BOTH = (3u),
+};
+
+typedef struct {
+    vu32_t inten;
+    vu32_t even;
+    vu32_t rten;
+    vu32_t ften;
+    vu32_t swiev;
+    vu32_t pd;
+} exti_regs_t;
+
+typedef struct {
+    vu32_t extiss[BS_EXTI_LINE_NUM / BS_EXTI_SEL_LINES];
+} exti_sel_regs_t;
+
+/* A deferred interrupt, pushed by the ISR and drained by a thread */
+typedef struct {
+    gpio_num_t port_pin;
+    u8_t edge;
+    u8_t rsvd;
+    u32_t timestamp;
+} exti_event_t;
+
+typedef void (*exti_handler_t)(gpio_num_t port_pin, u8_t edge, u32_t timestamp, void *pArg);
+
+u32_t exti_register(gpio_num_t port_pin, u8_t edges, exti_handler_t pFn, void *pArg, b_t deferred);
+u32_t exti_unregister(gpio_num_t port_pin);
+void exti_dispatch(u16_t lines);
+b_t exti_event_pop(exti_event_t *pEvent);
+u32_t exti_drain(u32_t max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,78 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#ifndef _BSI_FIELD_H_
+#define _BSI_FIELD_H_
+
+#include <stddef.h>
+#include "bsi_configuration.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The field mask and the field value going into one register */
+typedef struct {
+    u32_t mask;
+    u32_t value;
+} bs_field_t;
+
+enum {
+    BS_FIELD_RMW = (0u),
+    BS_FIELD_SET_RESET,
+};
+
+/* The map entry of a setting value the register cannot encode */
+#define BS_FIELD_INVALID (0xFFu)
+
+/**
+ * One field of a setting word: bits pos..pos+width-1 are checked against last, or translated by pMap, and then written into a lane of
+ * lane bits for every selected instance, e.g. every pin. The lane is a power of two up to 16, the lanes fill the register of the slot
+ * and continue in the next slot.
+ */
+typedef struct {
+    const u8_t *pMap;
+    u8_t pos;
+    u8_t width;
+    u8_t lane;
+    u8_t last;
+    u8_t slot;
+} bs_field_desc_t;
+
+/**
+ * One register of the batch, listed in commit order. BS_FIELD_RMW merges the slot into the register at offset. BS_FIELD_SET_RESET
+ * stores it once into a register whose low half sets and high half resets the bits, the register at state reads their current level.
+ */
+typedef struct {
+    u8_t slot;
+    u8_t kind;
+    u8_t offset;
+    u8_t state;
+} bs_field_reg_t;
+
+/* The table flags, BS_FIELD_ATOMIC merges the BS_FIELD_RMW registers with bs_reg_modify so concurrent field updates are never lost */
+#define BS_FIELD_ATOMIC (0x01u)
+
+/* The description of a peripheral configuration, one slot per register */
+typedef struct {
+    const bs_field_desc_t *pFields;
+    const bs_field_reg_t *pRegs;
+    u8_t field_num;
+    u8_t reg_num;
+    u8_t flags;
+} bs_field_table_t;
+
+#define BS_FIELD_OFFSET(type, reg) (u8_t)(offsetof(type, reg))
+#define BS_FIELD_SLOT(type, reg)   (u8_t)(offsetof(type, reg) / sizeof(bs_field_t))
+
+b_t bs_field_encode(const bs_field_table_t *pTable, u32_t setting, u32_t lanes, bs_field_t *pBatch);
+u8_t bs_field_apply(uptr_t base, const bs_field_table_t *pTable, const bs_field_t *pBatch, b_t diff);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -4,20 +4,35 @@
  * This source code is licensed under the MIT license found in the
  * LICENSE file in the root directory of this source tree.
  **/
+#ifndef _BSI_GPIO_H_
+#define _BSI_GPIO_H_
+
 #include "bsi_configuration.h"
+#include "bsi_field.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 /* The following table defined the At-BSI component number */
 enum {
     RESULT_INVALID_PORT = 1u,
     RESULT_INVALID_PIN,
     RESULT_INVALID_IN_OUT,
+    RESULT_INVALID_SETTING,
+    RESULT_INVALID_ARGS,
+    RESULT_NO_SPACE,
+    RESULT_MISMATCH,
+    RESULT_CORRUPTED,
+    RESULT_BUSY,
+    RESULT_NOT_OWNED,
 };
 
 typedef u8_t gpio_port_t;
 typedef u8_t gpio_pin_t;
 typedef u16_t gpio_num_t;
 
-#define BS_GPIO_PORT(num) (gpio_port_t)(((gpio_pin_t)(num) >> 8u) & 0xFFu)
+#define BS_GPIO_PORT(num) (gpio_port_t)(((gpio_num_t)(num) >> 8u) & 0xFFu)
 #define BS_GPIO_PIN(num)  (gpio_pin_t)((gpio_pin_t)(num) & 0xFFu)
 #define BS_GPIO_NUM(port, pin) (gpio_num_t)((((gpio_port_t)(port) & 0xFFu) << 8u) | ((gpio_pin_t)(pin) & 0xFFu))
 
@@ -101,6 +116,20 @@ typedef struct {
 
 #define GPIO_CTRL_1_VAL(...) CM(ARGS_NUM(__VA_ARGS__))(in_out, out_mode, speed, up_down, out_set, alternate, __VA_ARGS__)
 
+/* The inline code of the headers names the settings through GPIO_CTRL_1, C++ nests the enumerators in ctrl_1_b_t */
+#ifdef __cplusplus
+#define GPIO_CTRL_1(name) (ctrl_1_b_t::name)
+#else
+#define GPIO_CTRL_1(name) (name)
+#endif
+
+/* The ctrl_1_b_t fields allocate upwards from bit 0, the decoders assemble gpio_ctrl_1_t.value from these positions */
+#define GPIO_CTRL_1_POS_OUT_MODE  (2u)
+#define GPIO_CTRL_1_POS_SPEED     (3u)
+#define GPIO_CTRL_1_POS_UP_DOWN   (5u)
+#define GPIO_CTRL_1_POS_OUT_SET   (7u)
+#define GPIO_CTRL_1_POS_ALTERNATE (8u)
+
 typedef struct {
     u32_t lock : 1;
     enum {
@@ -129,21 +158,139 @@ typedef struct {
 #define CTRL_MSK   MASK_BIT(2)
 #define CTRL_SET(n, val) val  << n
 
+/* The field mask and the field value going into one register */
+typedef bs_field_t gpio_field_t;
+
+/* Evaluates to 0 in a constant expression, the build fails when a constant pin or setting is out of range */
+#define GPIO_IMG_CHECK(cond) (0u * (u32_t)sizeof(char[(cond) ? 1 : -1]))
+
+/* The pin lanes of the 1-bit, 2-bit and 4-bit register fields, the 4-bit lanes split into a low and a high register. The value is
+ * checked against the lane width and masked to it, so it never spills into the neighbouring pin */
+#define GPIO_IMG_LANE(pin, v, width)                                                                                                       \
+    (GPIO_IMG_CHECK(((u32_t)(pin) < 16u) && ((u32_t)(v) <= MASK_BIT(width))) + ((u32_t)(v) & MASK_BIT(width)))
+#define GPIO_IMG_L1(pin, v)     (GPIO_IMG_LANE(pin, v, 1u) << (pin))
+#define GPIO_IMG_L2(pin, v)     (GPIO_IMG_LANE(pin, v, 2u) << ((pin) * 2u))
+#define GPIO_IMG_L4(pin, v, hi) ((((u32_t)(pin) >> 3u) == (hi)) ? (GPIO_IMG_LANE(pin, v, 4u) << (((pin) & 7u) * 4u)) : 0u)
+
+/* The settings of one image entry against the last enumerator of every field, the bounds the C++ configure<> asserts as well */
+#define GPIO_IMG_SETTINGS(in_out, out_mode, speed, up_down, out_set, alternate)                                                            \
+    GPIO_IMG_CHECK(((u32_t)(in_out) <= 3u) && ((u32_t)(out_mode) <= 1u) && ((u32_t)(speed) <= 3u) && ((u32_t)(up_down) <= 2u) &&         \
+                   ((u32_t)(out_set) <= 1u) && ((u32_t)(alternate) <= 15u))
+
+#define GPIO_IMG_FIELD(list, m, v)                                                                                                         \
+    {                                                                                                                                      \
+        .mask = (0u list(m)), .value = (0u list(v))                                                                                        \
+    }
+
+/* Spread the 16 pin bits into the 2-bit lanes: bit n moves to bit 2n */
+static inline u32_t gpio_lane_2(u16_t pin_mask)
+{
+    u32_t x = pin_mask;
+
+    x = (x | (x << 8u)) & 0x00FF00FFu;
+    x = (x | (x << 4u)) & 0x0F0F0F0Fu;
+    x = (x | (x << 2u)) & 0x33333333u;
+    x = (x | (x << 1u)) & 0x55555555u;
+    return x;
+}
+
+/* Spread the 8 pin bits into the 4-bit lanes: bit n moves to bit 4n */
+static inline u32_t gpio_lane_4(u8_t pin_mask)
+{
+    u32_t x = pin_mask;
+
+    x = (x | (x << 12u)) & 0x000F000Fu;
+    x = (x | (x << 6u)) & 0x03030303u;
+    x = (x | (x << 3u)) & 0x11111111u;
+    return x;
+}
+
+/* Gather the 2-bit lanes back into pin bits, a pin is set when any bit of its lane is */
+static inline u16_t gpio_lane_2_pins(u32_t lanes)
+{
+    u32_t x = (lanes | (lanes >> 1u)) & 0x55555555u;
+
+    x = (x | (x >> 1u)) & 0x33333333u;
+    x = (x | (x >> 2u)) & 0x0F0F0F0Fu;
+    x = (x | (x >> 4u)) & 0x00FF00FFu;
+    x = (x | (x >> 8u)) & 0x0000FFFFu;
+    return (u16_t)x;
+}
+
+/* Gather the 4-bit lanes back into 8 pin bits, a pin is set when any bit of its lane is */
+static inline u8_t gpio_lane_4_pins(u32_t lanes)
+{
+    u32_t x = lanes | (lanes >> 2u);
+
+    x = (x | (x >> 1u)) & 0x11111111u;
+    x = (x | (x >> 3u)) & 0x03030303u;
+    x = (x | (x >> 6u)) & 0x000F000Fu;
+    x = (x | (x >> 12u)) & 0x000000FFu;
+    return (u8_t)x;
+}
+
+static inline u32_t gpio_field_merge(u32_t reg, const gpio_field_t *pField)
+{
+    return (reg & ~pField->mask) | pField->value;
+}
+
+/**
+ * A bidirectional pin handle for bit-banged buses. gpio_dir_init caches the address of the register holding the pin mode and the
+ * pre-shifted field values once, then gpio_dir_in and gpio_dir_out only touch that register. The output mode and level stay as
+ * configured by gpio_ctrl_1_set, e.g. open drain driving low for I2C and 1-Wire.
+ */
+typedef struct {
+    vu32_t *pCtrl;
+    u32_t ctrl_mask;
+    u32_t ctrl_in;
+    u32_t ctrl_out;
+    gpio_port_t port;
+#if BS_GPIO_SHADOW_ENABLED
+    u32_t *pShadowCtrl;
+#endif
+} gpio_dir_t;
+
+/* The register layout, gpio_update_t, the image folding and the setting encoder of the selected family */
+#if (BS_FAMILY == BS_FAMILY_GD32W51X)
+#include "gd32w51x/bsi_gpio_regs.h"
+#else
+#include "gd32f30x/bsi_gpio_regs.h"
+#endif
+
+/* The configuration registers and the output latch of every port, see gpio_snapshot */
 typedef struct {
-    vu32_t ctrl;
-    vu32_t out_mode;
-    vu32_t out_speed;
-    vu32_t up_down;
-    vu32_t in_status;
-    vu32_t out_ctrl;
-    vu32_t bit_op;
-    vu32_t lock;
-    vu32_t alt_fun_0;
-    vu32_t alt_fun_1;
-    vu32_t clear;
-    vu32_t toggle;
-    vu32_t secure;
-} gpio_regs_t;
+    gpio_cfg_regs_t cfg[BS_GPIO_PORT_NUM];
+    u16_t out_ctrl[BS_GPIO_PORT_NUM];
+} gpio_snapshot_t;
+
+/* Read the configuration registers of a port into a RAM image, one load per register */
+static inline void gpio_cfg_read(gpio_regs_t *pGpioRegs, gpio_cfg_regs_t *pCfg)
+{
+#define GPIO_CFG_READ(reg, width, first) pCfg->reg = BS_REG_RD(pGpioRegs->reg);
+    GPIO_CFG_REGS(GPIO_CFG_READ)
+#undef GPIO_CFG_READ
+}
+
+/* A per-port register image folded at compile time by GPIO_IMAGE */
+typedef struct {
+    gpio_port_t port;
+    gpio_update_t update;
+} gpio_image_t;
+
+/**
+ * GPIO_IMAGE(port, list) folds a board pin list into a constant gpio_image_t. The list is a macro taking the entry macro, every entry
+ * names the pin followed by the same six settings GPIO_CTRL_1_VAL takes:
+ *
+ *   #define BOARD_GPIO_A(PIN)                                                                                      \
+ *       PIN(BS_GPIO_PIN_5, CTRL_OUTPUT, CTRL_PUSH_PULL, CTRL_SPEED_LEVEL_3, CTRL_FLOAT, CTRL_LOW, CTRL_AF_FUNC_0) \
+ *       PIN(BS_GPIO_PIN_9, CTRL_AFIO, CTRL_PUSH_PULL, CTRL_SPEED_LEVEL_2, CTRL_PULL_UP, CTRL_LOW, CTRL_AF_FUNC_7)
+ *
+ *   static const gpio_image_t g_board_gpio[] = {GPIO_IMAGE(BS_GPIO_PORT_A, BOARD_GPIO_A)};
+ */
+#define GPIO_IMAGE(port_, list)                                                                                                            \
+    {                                                                                                                                      \
+        .port = (port_), .update = GPIO_IMAGE_UPDATE(list)                                                                                 \
+    }
 
 /* End of section using anonymous unions */
 #if defined(__CC_ARM)
@@ -151,3 +298,278 @@ typedef struct {
 #elif defined(__TASKING__)
 #pragma warning restore
 #endif
+
+static inline u32_t gpio_num_check(gpio_num_t port_pin)
+{
+    if (BS_GPIO_PORT(port_pin) >= BS_GPIO_PORT_NUM) {
+        return RESULT_INVALID_PORT;
+    }
+    if (BS_GPIO_PIN(port_pin) >= BS_GPIO_PIN_NUM) {
+        return RESULT_INVALID_PIN;
+    }
+    return 0;
+}
+
+#if BS_GPIO_ATOMIC_ENABLED
+/**
+ * Skip the register the update leaves alone, and store the register directly when the update covers it whole. Every other update is
+ * one exclusive read-modify-write, which also tells the diff mode whether the register changed.
+ */
+#define GPIO_REG_COMMIT(pRegs, pUpdate, reg, diff, writes)                                                                                 \
+    do {                                                                                                                                   \
+        if (!(pUpdate)->reg.mask) {                                                                                                        \
+            break;                                                                                                                         \
+        }                                                                                                                                  \
+        if ((!(diff)) && ((pUpdate)->reg.mask == U32_V)) {                                                                                 \
+            BS_REG_WR((pRegs)->reg, (pUpdate)->reg.value);                                                                                 \
+        } else {                                                                                                                           \
+            u32_t cur = BS_REG_MODIFY((pRegs)->reg, (pUpdate)->reg.mask, (pUpdate)->reg.value);                                            \
+            if ((diff) && (gpio_field_merge(cur, &(pUpdate)->reg) == cur)) {                                                               \
+                break;                                                                                                                     \
+            }                                                                                                                              \
+        }                                                                                                                                  \
+        (writes)++;                                                                                                                        \
+    } while (0)
+#else
+/**
+ * Skip the register the update leaves alone, and skip the read-back when the update covers the whole register. The diff mode always
+ * reads the register and stores it only when the merged content differs.
+ */
+#define GPIO_REG_COMMIT(pRegs, pUpdate, reg, diff, writes)                                                                                 \
+    do {                                                                                                                                   \
+        if (!(pUpdate)->reg.mask) {                                                                                                        \
+            break;                                                                                                                         \
+        }                                                                                                                                  \
+        if (diff) {                                                                                                                        \
+            u32_t cur = BS_REG_RD((pRegs)->reg);                                                                                           \
+            u32_t next = gpio_field_merge(cur, &(pUpdate)->reg);                                                                           \
+            if (next == cur) {                                                                                                             \
+                break;                                                                                                                     \
+            }                                                                                                                              \
+            BS_REG_WR((pRegs)->reg, next);                                                                                                 \
+        } else if ((pUpdate)->reg.mask == U32_V) {                                                                                         \
+            BS_REG_WR((pRegs)->reg, (pUpdate)->reg.value);                                                                                 \
+        } else {                                                                                                                           \
+            BS_REG_WR((pRegs)->reg, gpio_field_merge(BS_REG_RD((pRegs)->reg), &(pUpdate)->reg));                                           \
+        }                                                                                                                                  \
+        (writes)++;                                                                                                                        \
+    } while (0)
+#endif
+
+/**
+ * The output level, and on the GD32F30x the pull direction of the inputs with it, is latched through the bit operation register ahead
+ * of the mode switch, so no glitch appears on the pins. The diff mode compares against out_ctrl and skips the store when the pins
+ * already carry the level.
+ */
+static inline u8_t gpio_out_latch(gpio_regs_t *pGpioRegs, const gpio_update_t *pUpdate, b_t diff)
+{
+    u32_t set = pUpdate->out_ctrl.value;
+    u32_t reset = pUpdate->out_ctrl.mask & ~pUpdate->out_ctrl.value;
+
+    if (diff && pUpdate->out_ctrl.mask) {
+        u32_t octrl = BS_REG_RD(pGpioRegs->out_ctrl);
+        set &= ~octrl;
+        reset &= octrl;
+    }
+    if (!(set | reset)) {
+        return 0u;
+    }
+
+    BS_REG_WR(pGpioRegs->bit_op, set | (reset << 16u));
+    return 1u;
+}
+
+#if (!BS_GPIO_SHADOW_ENABLED) && (!BS_GPIO_FIELD_ENGINE_ENABLED)
+/* The direct commit of one port update in register order, inline so that a constant update keeps only the stores it needs */
+static inline u8_t gpio_update_commit(gpio_port_t port, gpio_regs_t *pGpioRegs, const gpio_update_t *pUpdate, b_t diff)
+{
+    u8_t writes = gpio_out_latch(pGpioRegs, pUpdate, diff);
+#define GPIO_COMMIT_REG(reg, width, first) GPIO_REG_COMMIT(pGpioRegs, pUpdate, reg, diff, writes);
+    GPIO_CFG_REGS(GPIO_COMMIT_REG)
+#undef GPIO_COMMIT_REG
+    BS_GPIO_HOOK(port);
+
+    return writes;
+}
+#endif
+
+/* A constant update needs no library state on its way to the port unless the shadow, the engine, the verify or the owner check is on */
+#define GPIO_UPDATE_COMMIT_INLINE                                                                                                          \
+    ((!BS_GPIO_SHADOW_ENABLED) && (!BS_GPIO_FIELD_ENGINE_ENABLED) && (!BS_GPIO_VERIFY_ENABLED) && (!BS_GPIO_OWNER_CHECK_ENABLED))
+
+/**
+ * The output helpers below issue exactly one store to a write-only register, so they are safe in ISRs without masking interrupts. The
+ * exception is gpio_toggle on a family without a toggle register, see BS_GPIO_HAS_TOGGLE.
+ */
+static inline u32_t gpio_set(gpio_num_t port_pin)
+{
+    u32_t result = gpio_num_check(port_pin);
+    if (result) {
+        return result;
+    }
+
+    gpio_regs_t *pGpioRegs = (gpio_regs_t *)gpio_base_regs_addr(BS_GPIO_PORT(port_pin));
+    BS_REG_WR(pGpioRegs->bit_op, SET_BIT(BS_GPIO_PIN(port_pin)));
+    BS_GPIO_HOOK(BS_GPIO_PORT(port_pin));
+    return 0;
+}
+
+static inline u32_t gpio_clear(gpio_num_t port_pin)
+{
+    u32_t result = gpio_num_check(port_pin);
+    if (result) {
+        return result;
+    }
+
+    gpio_regs_t *pGpioRegs = (gpio_regs_t *)gpio_base_regs_addr(BS_GPIO_PORT(port_pin));
+    BS_REG_WR(pGpioRegs->clear, SET_BIT(BS_GPIO_PIN(port_pin)));
+    BS_GPIO_HOOK(BS_GPIO_PORT(port_pin));
+    return 0;
+}
+
+static inline u32_t gpio_toggle(gpio_num_t port_pin)
+{
+    u32_t result = gpio_num_check(port_pin);
+    if (result) {
+        return result;
+    }
+
+    gpio_regs_t *pGpioRegs = (gpio_regs_t *)gpio_base_regs_addr(BS_GPIO_PORT(port_pin));
+#if BS_GPIO_HAS_TOGGLE
+    BS_REG_WR(pGpioRegs->toggle, SET_BIT(BS_GPIO_PIN(port_pin)));
+#else
+    /* Without a toggle register the latch is read back and inverted through bit_op, other pins stay safe but the pin itself is not */
+    u32_t bit = SET_BIT(BS_GPIO_PIN(port_pin));
+    BS_REG_WR(pGpioRegs->bit_op, (BS_REG_RD(pGpioRegs->out_ctrl) & bit) ? (bit << 16u) : bit);
+#endif
+    BS_GPIO_HOOK(BS_GPIO_PORT(port_pin));
+    return 0;
+}
+
+static inline u32_t gpio_write(gpio_num_t port_pin, b_t level)
+{
+    u32_t result = gpio_num_check(port_pin);
+    if (result) {
+        return result;
+    }
+
+    /* The low half of bit_op sets the pin and the high half resets it */
+    gpio_regs_t *pGpioRegs = (gpio_regs_t *)gpio_base_regs_addr(BS_GPIO_PORT(port_pin));
+    BS_REG_WR(pGpioRegs->bit_op, SET_BIT(BS_GPIO_PIN(port_pin) + (level ? 0u : 16u)));
+    BS_GPIO_HOOK(BS_GPIO_PORT(port_pin));
+    return 0;
+}
+
+/* Drive the masked pins of a port to the value bits with one combined set/reset store, untouched pins keep their level */
+static inline u32_t gpio_port_write_masked(gpio_port_t port, u16_t mask, u16_t value)
+{
+    if (port >= BS_GPIO_PORT_NUM) {
+        return RESULT_INVALID_PORT;
+    }
+
+    gpio_regs_t *pGpioRegs = (gpio_regs_t *)gpio_base_regs_addr(port);
+    BS_REG_WR(pGpioRegs->bit_op, ((u32_t)(mask & value)) | ((u32_t)(mask & (u16_t)~value) << 16u));
+    BS_GPIO_HOOK(port);
+    return 0;
+}
+
+/* An invalid port reads as all pins low */
+static inline u16_t gpio_port_read(gpio_port_t port)
+{
+    if (port >= BS_GPIO_PORT_NUM) {
+        return 0u;
+    }
+
+    gpio_regs_t *pGpioRegs = (gpio_regs_t *)gpio_base_regs_addr(port);
+    return (u16_t)(BS_REG_RD(pGpioRegs->in_status) & U16_V);
+}
+
+static inline u16_t gpio_port_read_masked(gpio_port_t port, u16_t mask)
+{
+    return gpio_port_read(port) & mask;
+}
+
+#if BS_GPIO_HAS_SECURE
+/**
+ * A set bit in the secure register keeps the pin in the secure world, which is the reset state. The register is only writable from
+ * the secure world, so these run in the secure firmware. Assigning all 16 pins skips the read-back and stores the register directly.
+ */
+static inline u32_t gpio_secure_assign(gpio_port_t port, u16_t pin_mask, b_t secure)
+{
+    if (port >= BS_GPIO_PORT_NUM) {
+        return RESULT_INVALID_PORT;
+    }
+
+    gpio_regs_t *pGpioRegs = (gpio_regs_t *)gpio_base_regs_addr(port);
+    u32_t value = secure ? pin_mask : 0u;
+    if (pin_mask == U16_V) {
+        BS_REG_WR(pGpioRegs->secure, value);
+    } else {
+        BS_REG_MODIFY(pGpioRegs->secure, pin_mask, value);
+    }
+    return 0;
+}
+
+/* The pins kept in the secure world, an invalid port reads as none */
+static inline u16_t gpio_secure_query(gpio_port_t port)
+{
+    if (port >= BS_GPIO_PORT_NUM) {
+        return 0u;
+    }
+
+    gpio_regs_t *pGpioRegs = (gpio_regs_t *)gpio_base_regs_addr(port);
+    return (u16_t)(BS_REG_RD(pGpioRegs->secure) & U16_V);
+}
+#endif
+
+static inline void gpio_dir_in(const gpio_dir_t *pDir)
+{
+#if BS_GPIO_SHADOW_ENABLED
+    u32_t ctrl = (*pDir->pShadowCtrl & ~pDir->ctrl_mask) | pDir->ctrl_in;
+    *pDir->pShadowCtrl = ctrl;
+    BS_REG_WR(*pDir->pCtrl, ctrl);
+#else
+    BS_REG_MODIFY(*pDir->pCtrl, pDir->ctrl_mask, pDir->ctrl_in);
+#endif
+    BS_GPIO_HOOK(pDir->port);
+}
+
+static inline void gpio_dir_out(const gpio_dir_t *pDir)
+{
+#if BS_GPIO_SHADOW_ENABLED
+    u32_t ctrl = (*pDir->pShadowCtrl & ~pDir->ctrl_mask) | pDir->ctrl_out;
+    *pDir->pShadowCtrl = ctrl;
+    BS_REG_WR(*pDir->pCtrl, ctrl);
+#else
+    BS_REG_MODIFY(*pDir->pCtrl, pDir->ctrl_mask, pDir->ctrl_out);
+#endif
+    BS_GPIO_HOOK(pDir->port);
+}
+
+u32_t gpio_ctrl_1_set(gpio_num_t port_pin, gpio_ctrl_1_t setting);
+u32_t gpio_ctrl_1_set_mask(gpio_port_t port, u16_t pin_mask, gpio_ctrl_1_t setting);
+u32_t gpio_ctrl_1_apply(gpio_num_t port_pin, gpio_ctrl_1_t setting, u8_t *pWrites);
+
+u32_t gpio_ctrl_1_get(gpio_num_t port_pin, gpio_ctrl_1_t *pSetting);
+u32_t gpio_port_decode(gpio_port_t port, gpio_ctrl_1_t *pSettings);
+
+u32_t gpio_apply_images(const gpio_image_t *pImages, u8_t num);
+u32_t gpio_dir_init(gpio_dir_t *pDir, gpio_num_t port_pin);
+
+u32_t gpio_snapshot(gpio_snapshot_t *pSnap);
+u32_t gpio_restore(const gpio_snapshot_t *pSnap);
+u32_t gpio_snapshot_park(gpio_snapshot_t *pSnap, const u16_t *pUsed);
+
+#if BS_GPIO_HAS_SECURE
+u32_t gpio_secure_apply(const u16_t *pSecure);
+#endif
+
+#if BS_GPIO_SHADOW_ENABLED
+u32_t gpio_shadow_sync(gpio_port_t port);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,120 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#ifndef _BSI_GPIO_HPP_
+#define _BSI_GPIO_HPP_
+
+#include "bsi_gpio.h"
+
+namespace bsi {
+
+/**
+ * The CTRL_* settings are enumerators of the anonymous enums inside ctrl_1_b_t and ctrl_2_b_t. C puts them at file scope while C++
+ * nests them in the structs, so they are re-exported here: C++ spells them bsi::CTRL_OUTPUT, or CTRL_OUTPUT after using namespace bsi,
+ * the same names C code uses. The qualified ctrl_1_b_t::CTRL_OUTPUT keeps working.
+ */
+#define BS_CTRL_1(name) constexpr u32_t name = ctrl_1_b_t::name;
+#define BS_CTRL_2(name) constexpr u32_t name = ctrl_2_b_t::name;
+BS_CTRL_1(CTRL_INPUT) BS_CTRL_1(CTRL_OUTPUT) BS_CTRL_1(CTRL_AFIO) BS_CTRL_1(CTRL_ANALOG)
+BS_CTRL_1(CTRL_PUSH_PULL) BS_CTRL_1(CTRL_OPEN_DRAIN)
+BS_CTRL_1(CTRL_SPEED_LEVEL_0) BS_CTRL_1(CTRL_SPEED_LEVEL_1) BS_CTRL_1(CTRL_SPEED_LEVEL_2) BS_CTRL_1(CTRL_SPEED_LEVEL_3)
+BS_CTRL_1(CTRL_FLOAT) BS_CTRL_1(CTRL_PULL_UP) BS_CTRL_1(CTRL_PULL_DOWN)
+BS_CTRL_1(CTRL_LOW) BS_CTRL_1(CTRL_HIGH)
+BS_CTRL_1(CTRL_AF_FUNC_0) BS_CTRL_1(CTRL_AF_FUNC_1) BS_CTRL_1(CTRL_AF_FUNC_2) BS_CTRL_1(CTRL_AF_FUNC_3)
+BS_CTRL_1(CTRL_AF_FUNC_4) BS_CTRL_1(CTRL_AF_FUNC_5) BS_CTRL_1(CTRL_AF_FUNC_6) BS_CTRL_1(CTRL_AF_FUNC_7)
+BS_CTRL_1(CTRL_AF_FUNC_8) BS_CTRL_1(CTRL_AF_FUNC_9) BS_CTRL_1(CTRL_AF_FUNC_10) BS_CTRL_1(CTRL_AF_FUNC_11)
+BS_CTRL_1(CTRL_AF_FUNC_12) BS_CTRL_1(CTRL_AF_FUNC_13) BS_CTRL_1(CTRL_AF_FUNC_14) BS_CTRL_1(CTRL_AF_FUNC_15)
+BS_CTRL_2(CTRL_UNLOCK) BS_CTRL_2(CTRL_LOCK)
+BS_CTRL_2(CTRL_POWER_ON) BS_CTRL_2(CTRL_POWER_OFF)
+#undef BS_CTRL_1
+#undef BS_CTRL_2
+
+#if !defined(BS_HOST_ENABLED)
+constexpr uptr_t gpio_base_addrs[BS_GPIO_PORT_NUM] = BS_GPIO_BASE_ADDRS;
+#endif
+
+/**
+ * A pin known at compile time. The port and pin are validated by static_assert, the register address and the field masks fold into
+ * constants, so set/clear/toggle/write are one store and read is one load with no range check. The C API stays the reference path.
+ */
+template <gpio_port_t Port, gpio_pin_t PinNum> struct Pin {
+    static_assert(Port < BS_GPIO_PORT_NUM, "the GPIO port is out of range");
+    static_assert(PinNum < BS_GPIO_PIN_NUM, "the GPIO pin is out of range");
+
+    static constexpr gpio_num_t num = (gpio_num_t)((Port << 8u) | PinNum);
+    static constexpr u32_t bit = (u32_t)1u << PinNum;
+
+    static inline gpio_regs_t *regs()
+    {
+#if defined(BS_HOST_ENABLED)
+        return (gpio_regs_t *)gpio_base_regs_addr(Port);
+#else
+        constexpr uptr_t addr = gpio_base_addrs[Port];
+        return reinterpret_cast<gpio_regs_t *>(addr);
+#endif
+    }
+
+    static inline void set()
+    {
+        BS_REG_WR(regs()->bit_op, bit);
+        BS_GPIO_HOOK(Port);
+    }
+
+    static inline void clear()
+    {
+        BS_REG_WR(regs()->clear, bit);
+        BS_GPIO_HOOK(Port);
+    }
+
+    static inline void toggle()
+    {
+#if BS_GPIO_HAS_TOGGLE
+        BS_REG_WR(regs()->toggle, bit);
+#else
+        BS_REG_WR(regs()->bit_op, (BS_REG_RD(regs()->out_ctrl) & bit) ? (bit << 16u) : bit);
+#endif
+        BS_GPIO_HOOK(Port);
+    }
+
+    static inline void write(bool level)
+    {
+        BS_REG_WR(regs()->bit_op, level ? bit : (bit << 16u));
+        BS_GPIO_HOOK(Port);
+    }
+
+    static inline bool read()
+    {
+        return (BS_REG_RD(regs()->in_status) & bit) != 0u;
+    }
+
+    /**
+     * The settings are folded into a constant update at compile time. The plain builds commit it inline, so only the stores of the
+     * registers the pin touches remain; the builds keeping library state take it through gpio_apply_images.
+     */
+    template <u32_t InOut, u32_t OutMode, u32_t Speed, u32_t UpDown, u32_t OutSet, u32_t Alternate> static inline u32_t configure()
+    {
+        static_assert((InOut <= 3u) && (OutMode <= 1u) && (Speed <= 3u) && (UpDown <= 2u) && (OutSet <= 1u) && (Alternate <= 15u),
+                      "the GPIO setting is out of range");
+
+#if GPIO_UPDATE_COMMIT_INLINE
+        static constexpr gpio_update_t update = GPIO_IMAGE_PIN_UPDATE(PinNum, InOut, OutMode, Speed, UpDown, OutSet, Alternate);
+        gpio_update_commit(Port, regs(), &update, FALSE);
+        return 0u;
+#else
+        static const gpio_image_t image = {Port, GPIO_IMAGE_PIN_UPDATE(PinNum, InOut, OutMode, Speed, UpDown, OutSet, Alternate)};
+        return gpio_apply_images(&image, 1u);
+#endif
+    }
+
+    static inline u32_t configure(gpio_ctrl_1_t setting)
+    {
+        return gpio_ctrl_1_set_mask(Port, (u16_t)bit, setting);
+    }
+};
+
+} // namespace bsi
+
+#endif
@@ -0,0 +1,59 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#ifndef _BSI_GPIO_CAPTURE_H_
+#define _BSI_GPIO_CAPTURE_H_
+
+#include "bsi_gpio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* One ring entry, the masked port level held for count kept samples */
+typedef struct {
+    u16_t level;
+    u16_t count;
+} gpio_capture_entry_t;
+
+/* The capture engine state over a caller-supplied ring, the oldest entries are overwritten once it is full */
+typedef struct {
+    gpio_regs_t *pGpioRegs;
+    gpio_capture_entry_t *pRing;
+    u32_t size;
+    u32_t head;
+    u32_t used;
+    u16_t mask;
+    u16_t decimation;
+    u16_t phase;
+    b_t rle;
+} gpio_capture_t;
+
+/* A level change found by the decoder, time counts kept samples from the oldest one in the ring */
+typedef struct {
+    u32_t time;
+    u16_t level;
+    u16_t changed;
+} gpio_capture_edge_t;
+
+typedef struct {
+    const gpio_capture_t *pCap;
+    u32_t index;
+    u32_t time;
+    u16_t level;
+} gpio_capture_iter_t;
+
+u32_t gpio_capture_init(gpio_capture_t *pCap, gpio_port_t port, u16_t mask, gpio_capture_entry_t *pRing, u32_t size, u16_t decimation,
+                        b_t rle);
+void gpio_capture_run(gpio_capture_t *pCap, u32_t samples);
+void gpio_capture_iter_init(gpio_capture_iter_t *pIter, const gpio_capture_t *pCap);
+b_t gpio_capture_iter_next(gpio_capture_iter_t *pIter, gpio_capture_edge_t *pEdge);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,67 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#ifndef _BSI_GPIO_DEBOUNCE_H_
+#define _BSI_GPIO_DEBOUNCE_H_
+
+#include "bsi_gpio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The counter planes bound the integration depth to 1..(2^planes - 1) samples */
+#define GPIO_DEBOUNCE_PLANES    (4u)
+#define GPIO_DEBOUNCE_DEPTH_MAX (MASK_BIT(GPIO_DEBOUNCE_PLANES))
+
+/**
+ * Vertical counters debouncing the 16 pins of a port at once. Bit n of plane i is bit i of the counter of pin n, which counts the
+ * consecutive samples disagreeing with the stable level; the pin flips once its counter reaches the depth.
+ */
+typedef struct {
+    u16_t plane[GPIO_DEBOUNCE_PLANES];
+    u16_t stable;
+    u16_t rising;
+    u16_t falling;
+    u8_t depth;
+} gpio_debounce_t;
+
+u32_t gpio_debounce_init(gpio_debounce_t *pDeb, u16_t initial, u8_t depth);
+
+static inline u16_t gpio_debounce_update(gpio_debounce_t *pDeb, u16_t sample)
+{
+    u16_t stable = pDeb->stable;
+    u16_t depth = pDeb->depth;
+    u16_t diff = sample ^ stable;
+    u16_t carry = diff;
+    u16_t reach = U16_V;
+    u16_t plane[GPIO_DEBOUNCE_PLANES];
+
+    /* Clear the counters of the agreeing pins, step the others and compare each plane against the depth */
+    for (u8_t i = 0u; i < GPIO_DEBOUNCE_PLANES; i++) {
+        u16_t cur = pDeb->plane[i] & diff;
+        plane[i] = cur ^ carry;
+        carry &= cur;
+        reach &= (depth & SET_BIT(i)) ? plane[i] : (u16_t)~plane[i];
+    }
+
+    u16_t flip = diff & reach;
+    for (u8_t i = 0u; i < GPIO_DEBOUNCE_PLANES; i++) {
+        pDeb->plane[i] = plane[i] & (u16_t)~flip;
+    }
+
+    stable ^= flip;
+    pDeb->stable = stable;
+    pDeb->rising = flip & stable;
+    pDeb->falling = flip & (u16_t)~stable;
+    return stable;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
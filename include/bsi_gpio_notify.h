@@ -0,0 +1,34 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#ifndef _BSI_GPIO_NOTIFY_H_
+#define _BSI_GPIO_NOTIFY_H_
+
+#include "bsi_gpio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+    GPIO_NOTIFY_RISING = (1u),
+    GPIO_NOTIFY_FALLING = (2u),
+    GPIO_NOTIFY_BOTH = (3u),
+};
+
+typedef void (*gpio_notify_fn_t)(gpio_num_t port_pin, b_t level, void *pArg);
+
+u32_t gpio_notify_register(gpio_num_t port_pin, u8_t edges, gpio_notify_fn_t pFn, void *pArg);
+u32_t gpio_notify_unregister(gpio_num_t port_pin);
+u32_t gpio_notify_sync(gpio_port_t port);
+u32_t gpio_notify_feed(gpio_port_t port, u16_t sample);
+u32_t gpio_notify_poll(gpio_port_t port);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,48 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#ifndef _BSI_GPIO_OWNER_H_
+#define _BSI_GPIO_OWNER_H_
+
+#include "bsi_gpio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef u8_t gpio_owner_t;
+
+#define GPIO_OWNER_NONE (0xFFu)
+
+/**
+ * The pin registry keeps one claimed bit per pin and a per-owner pin mask of every port. A claim or release is a couple of mask
+ * operations regardless of the pin count, a conflicting claim fails as a whole and reports the owner holding the pins. The registry is
+ * meant for driver initialization in thread context, it does not guard against concurrent claims.
+ */
+u32_t gpio_claim(gpio_num_t port_pin, gpio_owner_t owner);
+u32_t gpio_claim_mask(gpio_port_t port, u16_t pin_mask, gpio_owner_t owner, gpio_owner_t *pHolder);
+u32_t gpio_claim_af(gpio_num_t port_pin, gpio_owner_t owner, u8_t alternate);
+u32_t gpio_release(gpio_num_t port_pin, gpio_owner_t owner);
+u32_t gpio_release_mask(gpio_port_t port, u16_t pin_mask, gpio_owner_t owner);
+
+gpio_owner_t gpio_owner_of(gpio_num_t port_pin);
+u16_t gpio_claimed(gpio_port_t port);
+
+/**
+ * The checks behind BS_GPIO_OWNER_CHECK_ENABLED. The configuration calls run on behalf of the owner set by gpio_owner_select and only
+ * touch pins it holds, GPIO_OWNER_NONE, the default, accepts pins claimed by any owner, e.g. for board code configuring all drivers.
+ * A pin claimed through gpio_claim_af only takes its reserved function number when configured as an alternate function. The images
+ * of gpio_apply_images carry no setting at run time, so they get the ownership check only.
+ */
+gpio_owner_t gpio_owner_select(gpio_owner_t owner);
+u32_t gpio_owner_check(gpio_port_t port, u16_t pin_mask);
+u32_t gpio_owner_check_setting(gpio_port_t port, u16_t pin_mask, gpio_ctrl_1_t setting);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,39 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#ifndef _BSI_GPIO_TRACE_H_
+#define _BSI_GPIO_TRACE_H_
+
+#include "bsi_gpio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* One GPIO register store: the byte offset in gpio_regs_t, the value stored and the BS_TIMESTAMP taken right after it */
+typedef struct {
+    u32_t timestamp;
+    u32_t value;
+    u16_t seq;
+    u8_t port;
+    u8_t offset;
+} gpio_trace_entry_t;
+
+#if BS_GPIO_TRACE_ENABLED
+/**
+ * Every store through BS_REG_WR lands in a ring of BS_GPIO_TRACE_SIZE entries, the newest overwriting the oldest. Producers reserve
+ * their slot with one atomic increment, so ISRs and threads record without locking; seq holds the low bits of the store count so a
+ * dump shows the gaps. Read the ring once the recording is of interest, e.g. from a fault handler, as it keeps running meanwhile.
+ */
+u32_t gpio_trace_read(gpio_trace_entry_t *pEntries, u32_t max);
+void gpio_trace_reset(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
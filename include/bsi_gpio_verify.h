@@ -0,0 +1,42 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#ifndef _BSI_GPIO_VERIFY_H_
+#define _BSI_GPIO_VERIFY_H_
+
+#include "bsi_gpio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if BS_GPIO_VERIFY_ENABLED
+/**
+ * The configuration paths record every field they write together with a per-port CRC of the record. gpio_verify_step compares one
+ * configuration register against the record per call, walking all registers of all ports round robin, so the check spreads over idle
+ * time at one load per step. The record CRC is only checked once a difference shows up, a failing record is reported as
+ * RESULT_CORRUPTED rather than as a hardware mismatch. Only the fields written through the BSI layer are compared. gpio_dir_init
+ * releases the direction field of its pin, as gpio_dir_in/gpio_dir_out switch it without a record; a later gpio_ctrl_1_set or
+ * gpio_restore on the pin expects it again until the next gpio_dir_init. In shadow builds run gpio_shadow_sync on the port before
+ * repairing it, otherwise the shadow still matches and the repair writes nothing.
+ */
+void gpio_verify_record(gpio_port_t port, const gpio_update_t *pUpdate);
+void gpio_verify_record_cfg(gpio_port_t port, const gpio_cfg_regs_t *pCfg);
+void gpio_verify_release(gpio_port_t port, const gpio_update_t *pRelease);
+
+u32_t gpio_verify_port(gpio_port_t port, u16_t *pPins);
+u32_t gpio_verify_step(gpio_port_t *pPort, u16_t *pPins);
+
+#if defined(BS_HOST_ENABLED)
+gpio_field_t *bs_host_verify_record(gpio_port_t port);
+#endif
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,47 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#ifndef _BSI_GPIO_WAVE_H_
+#define _BSI_GPIO_WAVE_H_
+
+#include "bsi_gpio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* One edge of a pin timeline, the pin takes the level from the time slot on */
+typedef struct {
+    u32_t slot;
+    u8_t level;
+} gpio_wave_edge_t;
+
+/* The timeline of one pin, the edges are sorted by slot */
+typedef struct {
+    gpio_pin_t pin;
+    u8_t initial;
+    u16_t num;
+    const gpio_wave_edge_t *pEdges;
+} gpio_wave_pin_t;
+
+/* The bit_op word stored at the start of a run of identical time slots */
+typedef struct {
+    u32_t bit_op;
+    u32_t slots;
+} gpio_wave_step_t;
+
+/* The CPU playback waits the run length after each store, e.g. by polling a timer */
+typedef void (*gpio_wave_wait_t)(u32_t slots);
+
+u32_t gpio_wave_compile(const gpio_wave_pin_t *pPins, u8_t pin_num, u32_t length, gpio_wave_step_t *pSteps, u32_t *pStepNum);
+u32_t gpio_wave_expand(const gpio_wave_step_t *pSteps, u32_t step_num, u32_t *pWords, u32_t *pWordNum);
+u32_t gpio_wave_play(gpio_port_t port, const gpio_wave_step_t *pSteps, u32_t step_num, gpio_wave_wait_t pWait);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
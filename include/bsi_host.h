@@ -0,0 +1,33 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#ifndef _BSI_HOST_H_
+#define _BSI_HOST_H_
+
+#include "bsi_gpio.h"
+#include "bsi_exti.h"
+#include "bsi_gpio_trace.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(BS_HOST_ENABLED)
+gpio_regs_t *bs_host_gpio_regs(gpio_port_t port);
+void bs_host_gpio_input(gpio_port_t port, u16_t mask, u16_t level);
+void bs_host_gpio_reset(void);
+void bs_host_reg_count(u32_t *pLoads, u32_t *pStores);
+exti_regs_t *bs_host_exti_regs(void);
+exti_sel_regs_t *bs_host_exti_sel_regs(void);
+void bs_host_exti_raise(u16_t lines);
+u32_t bs_host_trace_replay(const gpio_trace_entry_t *pEntries, u32_t num);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,139 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#ifndef _BSI_GPIO_REGS_H_
+#define _BSI_GPIO_REGS_H_
+
+/* The GD32F30x port: one 4-bit mode nibble per pin in ctl_0/ctl_1, no toggle register, the pull direction comes from out_ctrl */
+#define BS_GPIO_HAS_TOGGLE (0u)
+#define BS_GPIO_HAS_SECURE (0u)
+
+/* A 128-entry map of the mode nibble would cost more flash than the hand-written encoder below, so there is no field table */
+#if BS_GPIO_FIELD_ENGINE_ENABLED
+#error "BS_GPIO_FIELD_ENGINE_ENABLED has no field table for the GD32F30x mode nibble"
+#endif
+
+typedef struct {
+    vu32_t ctl_0;
+    vu32_t ctl_1;
+    vu32_t in_status;
+    vu32_t out_ctrl;
+    vu32_t bit_op;
+    vu32_t clear;
+    vu32_t lock;
+} gpio_regs_t;
+
+/* The configuration registers of one port as a RAM image */
+typedef struct {
+    u32_t ctl_0;
+    u32_t ctl_1;
+} gpio_cfg_regs_t;
+
+/* The configuration registers with the bit width of a pin field and the first pin they hold, in commit order */
+#define GPIO_CFG_REGS(REG) REG(ctl_0, 4u, 0u) REG(ctl_1, 4u, 8u)
+
+/* The pending changes of the port registers, built once and committed in one pass */
+typedef struct {
+    gpio_field_t ctl_0;
+    gpio_field_t ctl_1;
+    gpio_field_t out_ctrl;
+} gpio_update_t;
+
+/**
+ * The nibble holds CTL in bits 3:2 and MD in bits 1:0. The settings are compared by their ctrl_1_b_t encoding so the macros fold in C
+ * and C++ alike: analog 0x0, floating input 0x4, pulled input 0x8, the outputs take CTL from the push-pull/open-drain and AFIO choice
+ * and MD from the speed level, 2MHz, 10MHz and 50MHz for levels 0, 1 and 2/3. The alternate function number has no field here.
+ */
+#define GPIO_F30X_MD(speed) (((u32_t)(speed) == 0u) ? 2u : (((u32_t)(speed) == 1u) ? 1u : 3u))
+#define GPIO_F30X_CTL(in_out, out_mode, speed, up_down)                                                                                    \
+    (((u32_t)(in_out) == 3u)   ? 0x0u                                                                                                      \
+     : ((u32_t)(in_out) == 0u) ? (((u32_t)(up_down) == 0u) ? 0x4u : 0x8u)                                                                  \
+                               : (((((u32_t)(in_out) == 2u) ? 2u : 0u) | (u32_t)(out_mode)) << 2u) | GPIO_F30X_MD(speed))
+
+/* A pulled input takes the pull direction from out_ctrl, every other mode keeps the requested output level */
+#define GPIO_F30X_OCTRL(in_out, up_down, out_set)                                                                                          \
+    ((((u32_t)(in_out) == 0u) && ((u32_t)(up_down) != 0u)) ? (((u32_t)(up_down) == 1u) ? 1u : 0u) : (u32_t)(out_set))
+
+#define GPIO_F30X_CTL_N(in_out, out_mode, speed, up_down, out_set, alternate)   GPIO_F30X_CTL(in_out, out_mode, speed, up_down)
+#define GPIO_F30X_OCTRL_N(in_out, out_mode, speed, up_down, out_set, alternate) GPIO_F30X_OCTRL(in_out, up_down, out_set)
+
+/* The alternate function number is validated for API parity only, the F30x routes peripherals through the AFIO remap instead */
+static inline u32_t gpio_ctrl_1_encode(u16_t pin_mask, gpio_ctrl_1_t setting, gpio_update_t *pUpdate)
+{
+    u32_t lane_1 = pin_mask;
+    u32_t lane_4_lo = gpio_lane_4((u8_t)(pin_mask & 0xFFu));
+    u32_t lane_4_hi = gpio_lane_4((u8_t)(pin_mask >> 8u));
+
+    u32_t in_out = BS_MAP_DIRECT(CB(setting, in_out), GPIO_CTRL_1(CTRL_ANALOG));
+    u32_t pd = BS_MAP_DIRECT(CB(setting, up_down), GPIO_CTRL_1(CTRL_PULL_DOWN));
+    u32_t omode = BS_MAP_DIRECT(CB(setting, out_mode), GPIO_CTRL_1(CTRL_OPEN_DRAIN));
+    u32_t speed = BS_MAP_DIRECT(CB(setting, speed), GPIO_CTRL_1(CTRL_SPEED_LEVEL_3));
+    u32_t octrl = BS_MAP_DIRECT(CB(setting, out_set), GPIO_CTRL_1(CTRL_HIGH));
+    u32_t alt = BS_MAP_DIRECT(CB(setting, alternate), GPIO_CTRL_1(CTRL_AF_FUNC_15));
+
+    if ((in_out == BS_MISMATCH) || (pd == BS_MISMATCH) || (omode == BS_MISMATCH) || (speed == BS_MISMATCH) || (octrl == BS_MISMATCH) ||
+        (alt == BS_MISMATCH)) {
+        return RESULT_INVALID_SETTING;
+    }
+
+    u32_t ctl = GPIO_F30X_CTL(in_out, omode, speed, pd);
+
+    pUpdate->ctl_0.mask = lane_4_lo * MASK_BIT(4);
+    pUpdate->ctl_0.value = lane_4_lo * ctl;
+    pUpdate->ctl_1.mask = lane_4_hi * MASK_BIT(4);
+    pUpdate->ctl_1.value = lane_4_hi * ctl;
+    pUpdate->out_ctrl.mask = lane_1 * MASK_BIT(1);
+    pUpdate->out_ctrl.value = lane_1 * GPIO_F30X_OCTRL(in_out, pd, octrl);
+
+    return 0;
+}
+
+/* The mode nibble of a floating input and of a 50MHz open-drain output */
+#define GPIO_F30X_CTL_IN_FLOAT (0x4u)
+#define GPIO_F30X_CTL_OUT_OD   (0x7u)
+
+/* The direction of a pin is its whole mode nibble, in ctl_0 for pins 0-7 and ctl_1 for pins 8-15 */
+#define GPIO_DIR_CTRL(pRegs, pin) (((pin) < 8u) ? &(pRegs)->ctl_0 : &(pRegs)->ctl_1)
+
+/**
+ * The output nibble also carries the output type and speed, so the one configured on the pin is kept, or open drain when it is an
+ * input. A non-zero MD field marks an output nibble, an analog pin turns into a floating input.
+ */
+static inline void gpio_dir_encode(gpio_dir_t *pDir, gpio_pin_t pin, u32_t ctrl)
+{
+    u32_t shift = (pin & 7u) * 4u;
+    u32_t ctl = (ctrl >> shift) & MASK_BIT(4);
+    b_t output = (ctl & MASK_BIT(2)) ? TRUE : FALSE;
+
+    pDir->ctrl_mask = MASK_BIT(4) << shift;
+    pDir->ctrl_in = ((output || !ctl) ? GPIO_F30X_CTL_IN_FLOAT : ctl) << shift;
+    pDir->ctrl_out = (output ? ctl : GPIO_F30X_CTL_OUT_OD) << shift;
+}
+
+#define GPIO_IMG_CTL_0_M(pin, ...) | GPIO_IMG_L4(pin, MASK_BIT(4), 0u)
+#define GPIO_IMG_CTL_0_V(pin, ...) | GPIO_IMG_L4(pin, GPIO_F30X_CTL_N(__VA_ARGS__), 0u)
+#define GPIO_IMG_CTL_1_M(pin, ...) | GPIO_IMG_L4(pin, MASK_BIT(4), 1u)
+#define GPIO_IMG_CTL_1_V(pin, ...) | GPIO_IMG_L4(pin, GPIO_F30X_CTL_N(__VA_ARGS__), 1u)
+#define GPIO_IMG_OCTRL_M(pin, ...) | GPIO_IMG_L1(pin, MASK_BIT(1))
+#define GPIO_IMG_OCTRL_V(pin, ...) | GPIO_IMG_L1(pin, GPIO_F30X_OCTRL_N(__VA_ARGS__)) | GPIO_IMG_SETTINGS(__VA_ARGS__)
+
+#define GPIO_IMAGE_UPDATE(list)                                                                                                            \
+    {                                                                                                                                      \
+        .ctl_0 = GPIO_IMG_FIELD(list, GPIO_IMG_CTL_0_M, GPIO_IMG_CTL_0_V),                                                                 \
+        .ctl_1 = GPIO_IMG_FIELD(list, GPIO_IMG_CTL_1_M, GPIO_IMG_CTL_1_V),                                                                 \
+        .out_ctrl = GPIO_IMG_FIELD(list, GPIO_IMG_OCTRL_M, GPIO_IMG_OCTRL_V),                                                              \
+    }
+
+/* The update of a single pin in member order, usable where designated initializers are not, e.g. in C++ */
+#define GPIO_IMAGE_PIN_UPDATE(pin, in_out, out_mode, speed, up_down, out_set, alternate)                                                   \
+    {                                                                                                                                      \
+        {GPIO_IMG_L4(pin, MASK_BIT(4), 0u), GPIO_IMG_L4(pin, GPIO_F30X_CTL(in_out, out_mode, speed, up_down), 0u)},                        \
+            {GPIO_IMG_L4(pin, MASK_BIT(4), 1u), GPIO_IMG_L4(pin, GPIO_F30X_CTL(in_out, out_mode, speed, up_down), 1u)},                    \
+            {GPIO_IMG_L1(pin, MASK_BIT(1)), GPIO_IMG_L1(pin, GPIO_F30X_OCTRL(in_out, up_down, out_set)) |                                  \
+                                                GPIO_IMG_SETTINGS(in_out, out_mode, speed, up_down, out_set, alternate)},                  \
+    }
+
+#endif
@@ -0,0 +1,162 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#ifndef _BSI_GPIO_REGS_H_
+#define _BSI_GPIO_REGS_H_
+
+/* The GD32W51x port: 2-bit mode, speed and pull fields, the output type and the alternate function split into their own registers */
+#define BS_GPIO_HAS_TOGGLE (1u)
+#define BS_GPIO_HAS_SECURE (1u)
+
+typedef struct {
+    vu32_t ctrl;
+    vu32_t out_mode;
+    vu32_t out_speed;
+    vu32_t up_down;
+    vu32_t in_status;
+    vu32_t out_ctrl;
+    vu32_t bit_op;
+    vu32_t lock;
+    vu32_t alt_fun_0;
+    vu32_t alt_fun_1;
+    vu32_t clear;
+    vu32_t toggle;
+    vu32_t secure;
+} gpio_regs_t;
+
+/* The configuration registers of one port as a RAM image */
+typedef struct {
+    u32_t ctrl;
+    u32_t out_mode;
+    u32_t out_speed;
+    u32_t up_down;
+    u32_t alt_fun_0;
+    u32_t alt_fun_1;
+} gpio_cfg_regs_t;
+
+/**
+ * The configuration registers with the bit width of a pin field and the first pin they hold, in commit order: the pulls and the output
+ * stage ahead of the mode switch in ctrl, so a pin only becomes an output once its type and function are in place.
+ */
+#define GPIO_CFG_REGS(REG)                                                                                                                 \
+    REG(up_down, 2u, 0u) REG(out_mode, 1u, 0u) REG(out_speed, 2u, 0u) REG(alt_fun_0, 4u, 0u) REG(alt_fun_1, 4u, 8u) REG(ctrl, 2u, 0u)
+
+/* The pending changes of the port registers, built once and committed in one pass */
+typedef struct {
+    gpio_field_t ctrl;
+    gpio_field_t out_mode;
+    gpio_field_t out_speed;
+    gpio_field_t up_down;
+    gpio_field_t out_ctrl;
+    gpio_field_t alt_fun_0;
+    gpio_field_t alt_fun_1;
+} gpio_update_t;
+
+/* The ctrl_1_b_t fields map one to one onto register fields, each one is spread into the lanes of the selected pins */
+static inline u32_t gpio_ctrl_1_encode_direct(u16_t pin_mask, gpio_ctrl_1_t setting, gpio_update_t *pUpdate)
+{
+    u32_t lane_1 = pin_mask;
+    u32_t lane_2 = gpio_lane_2(pin_mask);
+    u32_t lane_4_lo = gpio_lane_4((u8_t)(pin_mask & 0xFFu));
+    u32_t lane_4_hi = gpio_lane_4((u8_t)(pin_mask >> 8u));
+
+    u32_t in_out = BS_MAP_DIRECT(CB(setting, in_out), GPIO_CTRL_1(CTRL_ANALOG));
+    u32_t pd = BS_MAP_DIRECT(CB(setting, up_down), GPIO_CTRL_1(CTRL_PULL_DOWN));
+    u32_t omode = BS_MAP_DIRECT(CB(setting, out_mode), GPIO_CTRL_1(CTRL_OPEN_DRAIN));
+    u32_t speed = BS_MAP_DIRECT(CB(setting, speed), GPIO_CTRL_1(CTRL_SPEED_LEVEL_3));
+    u32_t octrl = BS_MAP_DIRECT(CB(setting, out_set), GPIO_CTRL_1(CTRL_HIGH));
+    u32_t alt = BS_MAP_DIRECT(CB(setting, alternate), GPIO_CTRL_1(CTRL_AF_FUNC_15));
+
+    if ((in_out == BS_MISMATCH) || (pd == BS_MISMATCH) || (omode == BS_MISMATCH) || (speed == BS_MISMATCH) || (octrl == BS_MISMATCH) ||
+        (alt == BS_MISMATCH)) {
+        return RESULT_INVALID_SETTING;
+    }
+
+    pUpdate->ctrl.mask = lane_2 * MASK_BIT(2);
+    pUpdate->ctrl.value = lane_2 * in_out;
+    pUpdate->up_down.mask = lane_2 * MASK_BIT(2);
+    pUpdate->up_down.value = lane_2 * pd;
+    pUpdate->out_mode.mask = lane_1 * MASK_BIT(1);
+    pUpdate->out_mode.value = lane_1 * omode;
+    pUpdate->out_speed.mask = lane_2 * MASK_BIT(2);
+    pUpdate->out_speed.value = lane_2 * speed;
+    pUpdate->out_ctrl.mask = lane_1 * MASK_BIT(1);
+    pUpdate->out_ctrl.value = lane_1 * octrl;
+    pUpdate->alt_fun_0.mask = lane_4_lo * MASK_BIT(4);
+    pUpdate->alt_fun_0.value = lane_4_lo * alt;
+    pUpdate->alt_fun_1.mask = lane_4_hi * MASK_BIT(4);
+    pUpdate->alt_fun_1.value = lane_4_hi * alt;
+
+    return 0;
+}
+
+#if BS_GPIO_FIELD_ENGINE_ENABLED
+/* The size build encodes and commits through the shared field engine, the same fields described by g_gpio_field_table */
+extern const bs_field_table_t g_gpio_field_table;
+
+static inline u32_t gpio_ctrl_1_encode(u16_t pin_mask, gpio_ctrl_1_t setting, gpio_update_t *pUpdate)
+{
+    if (!bs_field_encode(&g_gpio_field_table, setting.value, pin_mask, (bs_field_t *)pUpdate)) {
+        return RESULT_INVALID_SETTING;
+    }
+    return 0;
+}
+#else
+static inline u32_t gpio_ctrl_1_encode(u16_t pin_mask, gpio_ctrl_1_t setting, gpio_update_t *pUpdate)
+{
+    return gpio_ctrl_1_encode_direct(pin_mask, setting, pUpdate);
+}
+#endif
+
+/* The direction of a pin is its 2-bit ctrl field, the output type, speed and level live in registers of their own */
+#define GPIO_DIR_CTRL(pRegs, pin) (&(pRegs)->ctrl)
+
+static inline void gpio_dir_encode(gpio_dir_t *pDir, gpio_pin_t pin, u32_t ctrl)
+{
+    UNUSED_MSG(ctrl);
+    pDir->ctrl_mask = MASK_BIT(2) << (pin * 2u);
+    pDir->ctrl_in = (u32_t)GPIO_CTRL_1(CTRL_INPUT) << (pin * 2u);
+    pDir->ctrl_out = (u32_t)GPIO_CTRL_1(CTRL_OUTPUT) << (pin * 2u);
+}
+
+#define GPIO_IMG_CTRL_M(pin, ...)  | GPIO_IMG_L2(pin, MASK_BIT(2))
+#define GPIO_IMG_CTRL_V(pin, ...)  | GPIO_IMG_L2(pin, ARGS_N(1, __VA_ARGS__))
+#define GPIO_IMG_OMODE_M(pin, ...) | GPIO_IMG_L1(pin, MASK_BIT(1))
+#define GPIO_IMG_OMODE_V(pin, ...) | GPIO_IMG_L1(pin, ARGS_N(2, __VA_ARGS__))
+#define GPIO_IMG_SPEED_M(pin, ...) | GPIO_IMG_L2(pin, MASK_BIT(2))
+#define GPIO_IMG_SPEED_V(pin, ...) | GPIO_IMG_L2(pin, ARGS_N(3, __VA_ARGS__))
+#define GPIO_IMG_PD_M(pin, ...)    | GPIO_IMG_L2(pin, MASK_BIT(2))
+#define GPIO_IMG_PD_V(pin, ...)    | GPIO_IMG_L2(pin, ARGS_N(4, __VA_ARGS__))
+#define GPIO_IMG_OCTRL_M(pin, ...) | GPIO_IMG_L1(pin, MASK_BIT(1))
+#define GPIO_IMG_OCTRL_V(pin, ...) | GPIO_IMG_L1(pin, ARGS_N(5, __VA_ARGS__)) | GPIO_IMG_SETTINGS(__VA_ARGS__)
+#define GPIO_IMG_ALT_0_M(pin, ...) | GPIO_IMG_L4(pin, MASK_BIT(4), 0u)
+#define GPIO_IMG_ALT_0_V(pin, ...) | GPIO_IMG_L4(pin, ARGS_N(6, __VA_ARGS__), 0u)
+#define GPIO_IMG_ALT_1_M(pin, ...) | GPIO_IMG_L4(pin, MASK_BIT(4), 1u)
+#define GPIO_IMG_ALT_1_V(pin, ...) | GPIO_IMG_L4(pin, ARGS_N(6, __VA_ARGS__), 1u)
+
+#define GPIO_IMAGE_UPDATE(list)                                                                                                            \
+    {                                                                                                                                      \
+        .ctrl = GPIO_IMG_FIELD(list, GPIO_IMG_CTRL_M, GPIO_IMG_CTRL_V),                                                                    \
+        .out_mode = GPIO_IMG_FIELD(list, GPIO_IMG_OMODE_M, GPIO_IMG_OMODE_V),                                                              \
+        .out_speed = GPIO_IMG_FIELD(list, GPIO_IMG_SPEED_M, GPIO_IMG_SPEED_V),                                                             \
+        .up_down = GPIO_IMG_FIELD(list, GPIO_IMG_PD_M, GPIO_IMG_PD_V),                                                                     \
+        .out_ctrl = GPIO_IMG_FIELD(list, GPIO_IMG_OCTRL_M, GPIO_IMG_OCTRL_V),                                                              \
+        .alt_fun_0 = GPIO_IMG_FIELD(list, GPIO_IMG_ALT_0_M, GPIO_IMG_ALT_0_V),                                                             \
+        .alt_fun_1 = GPIO_IMG_FIELD(list, GPIO_IMG_ALT_1_M, GPIO_IMG_ALT_1_V),                                                             \
+    }
+
+/* The update of a single pin in member order, usable where designated initializers are not, e.g. in C++ */
+#define GPIO_IMAGE_PIN_UPDATE(pin, in_out, out_mode, speed, up_down, out_set, alternate)                                                   \
+    {                                                                                                                                      \
+        {GPIO_IMG_L2(pin, MASK_BIT(2)), GPIO_IMG_L2(pin, in_out)}, {GPIO_IMG_L1(pin, MASK_BIT(1)), GPIO_IMG_L1(pin, out_mode)},            \
+            {GPIO_IMG_L2(pin, MASK_BIT(2)), GPIO_IMG_L2(pin, speed)}, {GPIO_IMG_L2(pin, MASK_BIT(2)), GPIO_IMG_L2(pin, up_down)},          \
+            {GPIO_IMG_L1(pin, MASK_BIT(1)),                                                                                                \
+             GPIO_IMG_L1(pin, out_set) | GPIO_IMG_SETTINGS(in_out, out_mode, speed, up_down, out_set, alternate)},                         \
+            {GPIO_IMG_L4(pin, MASK_BIT(4), 0u), GPIO_IMG_L4(pin, alternate, 0u)},                                                          \
+            {GPIO_IMG_L4(pin, MASK_BIT(4), 1u), GPIO_IMG_L4(pin, alternate, 1u)},                                                          \
+    }
+
+#endif
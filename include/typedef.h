@@ -39,6 +39,7 @@ typedef volatile signed int vi32_t;
 typedef volatile signed long long vi64_t;
 typedef bool b_t;
 typedef u32_t u32p_t;
+typedef size_t uptr_t;
 
 #ifndef FALSE
 #define FALSE false
@@ -84,6 +85,28 @@ typedef u32_t u32p_t;
     BV_C(v, m, p);                                                                                                                         \
     BV_S(v, m, p, n)
 
+/* Count trailing zeros of a non-zero word, the index of its lowest set bit */
+#if defined(__GNUC__) || defined(__clang__)
+#define BS_CTZ(x) ((u8_t)__builtin_ctz((u32_t)(x)))
+#elif defined(__CC_ARM)
+#define BS_CTZ(x) ((u8_t)__clz(__rbit((u32_t)(x))))
+#elif defined(__ICCARM__)
+#include <intrinsics.h>
+#define BS_CTZ(x) ((u8_t)__CLZ(__RBIT((u32_t)(x))))
+#else
+static inline u8_t bs_ctz(u32_t x)
+{
+    u8_t n = 0u;
+
+    while (!(x & 1u)) {
+        x >>= 1u;
+        n++;
+    }
+    return n;
+}
+#define BS_CTZ(x) bs_ctz((u32_t)(x))
+#endif
+
 #define DEQUALIFY(s, v)      ((s)(u32_t)(const volatile void *)(v))
 #define OFFSETOF(s, m)       ((u32_t)(&((s *)0)->m))
 #define CONTAINEROF(p, s, m) (DEQUALIFY(s *, ((const vu8_t *)(p)-OFFSETOF(s, m))))
@@ -162,7 +185,7 @@ typedef u32_t u32p_t;
 #define ARGS_N(N, ...)  AG(N)(__VA_ARGS__)
 
 #define CBITS           .bits.
-#define CV_3(pre, post) MAGIC(pre, post)
+#define CV_3(pre, post) pre post
 #define CV_2(pre, post) CV_3(pre, post)
 #define CV(m)           CV_2(CBITS, m)
 #define CB(c, b)        CV_2(c, CV(b))
@@ -582,6 +605,13 @@ typedef u32_t u32p_t;
 #define BS(m)            CMV_2(BSV, m)
 #define BS_MAP(c, ...)   BS(ARGS_NUM(__VA_ARGS__))(c, __VA_ARGS__)
 
+/* Identity decoding for an enumeration numbered 0..last, one compare instead of the BS_MAP chain; the values beyond last still give
+ * BS_MISMATCH */
+#define BS_MAP_DIRECT(c, last) (((u32_t)(c) <= (u32_t)(last)) ? (u32_t)(c) : BS_MISMATCH)
+
+/* Compile-time check for the conditions BS_MAP_DIRECT relies on, usable at file scope */
+#define BS_STATIC_ASSERT(cond) typedef char AG_2(bs_static_assert_, COMPLIER_UNIQUE_NUMBER)[(cond) ? 1 : -1]
+
 #ifdef __cplusplus
 }
 #endif
@@ -6,5 +6,9 @@
  **/
 #include "bsi_configuration.h"
 
-vu32_t g_gpio_base_regs[BS_GPIO_PORT_NUM] = {GPIOA, GPIOB, GPIOC};
+#if !defined(BS_HOST_ENABLED)
+const uptr_t g_gpio_base_regs[BS_GPIO_PORT_NUM] = BS_GPIO_BASE_ADDRS;
+const uptr_t g_exti_base_regs = EXTI;
+const uptr_t g_exti_sel_regs = BS_EXTI_SEL_BASE_ADDR;
+#endif
 
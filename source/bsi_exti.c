@@ -0,0 +1,178 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "bsi_exti.h"
+
+BS_STATIC_ASSERT((BS_EXTI_QUEUE_SIZE & (BS_EXTI_QUEUE_SIZE - 1u)) == 0u);
+
+typedef struct {
+    exti_handler_t pFn;
+    void *pArg;
+    gpio_port_t port;
+    u8_t edges;
+    b_t deferred;
+} exti_line_t;
+
+/* The single-producer single-consumer queue, the ISR only moves head and the thread only moves tail */
+typedef struct {
+    exti_event_t event[BS_EXTI_QUEUE_SIZE];
+    vu32_t head;
+    vu32_t tail;
+} exti_queue_t;
+
+static exti_line_t g_exti_line[BS_EXTI_LINE_NUM];
+static exti_queue_t g_exti_queue;
+
+u32_t exti_register(gpio_num_t port_pin, u8_t edges, exti_handler_t pFn, void *pArg, b_t deferred)
+{
+    u32_t result = gpio_num_check(port_pin);
+    if (result) {
+        return result;
+    }
+    if ((!pFn) || (!(edges & EXTI_EDGE_BOTH))) {
+        return RESULT_INVALID_ARGS;
+    }
+
+    gpio_pin_t line = BS_GPIO_PIN(port_pin);
+    exti_line_t *pLine = &g_exti_line[line];
+    if (pLine->pFn && (pLine->port != BS_GPIO_PORT(port_pin))) {
+        return RESULT_INVALID_PIN;
+    }
+
+    exti_regs_t *pExtiRegs = (exti_regs_t *)exti_base_regs_addr();
+    exti_sel_regs_t *pSelRegs = (exti_sel_regs_t *)exti_sel_regs_addr();
+    vu32_t *pSel = &pSelRegs->extiss[line / BS_EXTI_SEL_LINES];
+    u32_t shift = (line % BS_EXTI_SEL_LINES) * BS_EXTI_SEL_WIDTH;
+    u32_t bit = SET_BIT(line);
+
+    /* The line stays masked while it is routed onto the port and its edges are armed */
+    BS_REG_WR(pExtiRegs->inten, BS_REG_RD(pExtiRegs->inten) & ~bit);
+    BS_REG_WR(*pSel, (BS_REG_RD(*pSel) & ~(MASK_BIT(BS_EXTI_SEL_WIDTH) << shift)) | ((u32_t)BS_GPIO_PORT(port_pin) << shift));
+    pLine->pFn = pFn;
+    pLine->pArg = pArg;
+    pLine->port = BS_GPIO_PORT(port_pin);
+    pLine->edges = edges & EXTI_EDGE_BOTH;
+    pLine->deferred = deferred;
+
+    u32_t rten = BS_REG_RD(pExtiRegs->rten) & ~bit;
+    u32_t ften = BS_REG_RD(pExtiRegs->ften) & ~bit;
+    BS_REG_WR(pExtiRegs->rten, (edges & EXTI_EDGE_RISING) ? (rten | bit) : rten);
+    BS_REG_WR(pExtiRegs->ften, (edges & EXTI_EDGE_FALLING) ? (ften | bit) : ften);
+    BS_REG_WR(pExtiRegs->pd, bit);
+    BS_EXTI_HOOK();
+    BS_REG_WR(pExtiRegs->inten, BS_REG_RD(pExtiRegs->inten) | bit);
+
+    return 0;
+}
+
+u32_t exti_unregister(gpio_num_t port_pin)
+{
+    u32_t result = gpio_num_check(port_pin);
+    if (result) {
+        return result;
+    }
+
+    gpio_pin_t line = BS_GPIO_PIN(port_pin);
+    exti_line_t *pLine = &g_exti_line[line];
+    if ((!pLine->pFn) || (pLine->port != BS_GPIO_PORT(port_pin))) {
+        return RESULT_INVALID_PIN;
+    }
+
+    exti_regs_t *pExtiRegs = (exti_regs_t *)exti_base_regs_addr();
+    u32_t bit = SET_BIT(line);
+
+    BS_REG_WR(pExtiRegs->inten, BS_REG_RD(pExtiRegs->inten) & ~bit);
+    BS_REG_WR(pExtiRegs->rten, BS_REG_RD(pExtiRegs->rten) & ~bit);
+    BS_REG_WR(pExtiRegs->ften, BS_REG_RD(pExtiRegs->ften) & ~bit);
+    pLine->pFn = NULL;
+
+    return 0;
+}
+
+/* A line armed for one edge only is known without touching the port, otherwise the current pin level tells the edge */
+static inline u8_t _exti_edge(const exti_line_t *pLine, u8_t line)
+{
+    if (pLine->edges != EXTI_EDGE_BOTH) {
+        return pLine->edges;
+    }
+    return (gpio_port_read(pLine->port) & SET_BIT(line)) ? EXTI_EDGE_RISING : EXTI_EDGE_FALLING;
+}
+
+/**
+ * Called from the EXTI ISRs with the lines the vector serves. The pending lines are acknowledged with one load and one store, then each
+ * pending line costs one table lookup and either the direct handler call or one queue push; a full queue drops the event.
+ */
+void exti_dispatch(u16_t lines)
+{
+    exti_regs_t *pExtiRegs = (exti_regs_t *)exti_base_regs_addr();
+    u32_t pending = BS_REG_RD(pExtiRegs->pd) & lines;
+    u32_t timestamp = BS_TIMESTAMP();
+
+    if (!pending) {
+        return;
+    }
+    BS_REG_WR(pExtiRegs->pd, pending);
+    BS_EXTI_HOOK();
+
+    while (pending) {
+        u8_t line = BS_CTZ(pending);
+        pending &= pending - 1u;
+
+        const exti_line_t *pLine = &g_exti_line[line];
+        if (!pLine->pFn) {
+            continue;
+        }
+
+        u8_t edge = _exti_edge(pLine, line);
+        if (!pLine->deferred) {
+            pLine->pFn(BS_GPIO_NUM(pLine->port, line), edge, timestamp, pLine->pArg);
+            continue;
+        }
+
+        u32_t head = g_exti_queue.head;
+        if ((head - g_exti_queue.tail) >= BS_EXTI_QUEUE_SIZE) {
+            continue;
+        }
+        exti_event_t *pEvent = &g_exti_queue.event[head & (BS_EXTI_QUEUE_SIZE - 1u)];
+        pEvent->port_pin = BS_GPIO_NUM(pLine->port, line);
+        pEvent->edge = edge;
+        pEvent->timestamp = timestamp;
+        BS_MEMORY_BARRIER();
+        g_exti_queue.head = head + 1u;
+    }
+}
+
+/* The thread side of the deferred queue */
+b_t exti_event_pop(exti_event_t *pEvent)
+{
+    u32_t tail = g_exti_queue.tail;
+    if (tail == g_exti_queue.head) {
+        return FALSE;
+    }
+
+    BS_MEMORY_BARRIER();
+    *pEvent = g_exti_queue.event[tail & (BS_EXTI_QUEUE_SIZE - 1u)];
+    BS_MEMORY_BARRIER();
+    g_exti_queue.tail = tail + 1u;
+    return TRUE;
+}
+
+/* Call the handlers of up to max deferred events from the thread context, 0 drains the whole queue */
+u32_t exti_drain(u32_t max)
+{
+    exti_event_t event;
+    u32_t num = 0u;
+
+    while (((!max) || (num < max)) && exti_event_pop(&event)) {
+        const exti_line_t *pLine = &g_exti_line[BS_GPIO_PIN(event.port_pin)];
+        if (pLine->pFn) {
+            pLine->pFn(event.port_pin, event.edge, event.timestamp, pLine->pArg);
+        }
+        num++;
+    }
+
+    return num;
+}
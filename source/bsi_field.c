@@ -0,0 +1,107 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "bsi_field.h"
+
+#if BS_GPIO_FIELD_ENGINE_ENABLED
+
+/* Move bit n of bits to bit n * lane by doubling the lanes as gpio_lane_2 does, the lane is a power of two and bits fit 32 / lane */
+static u32_t _bs_field_spread(u32_t bits, u8_t lane)
+{
+    for (; lane > 1u; lane >>= 1u) {
+        bits = (bits | (bits << 8u)) & 0x00FF00FFu;
+        bits = (bits | (bits << 4u)) & 0x0F0F0F0Fu;
+        bits = (bits | (bits << 2u)) & 0x33333333u;
+        bits = (bits | (bits << 1u)) & 0x55555555u;
+    }
+    return bits;
+}
+
+/* Decode the setting and build the field batch for the selected lanes, FALSE when a setting value cannot be encoded */
+b_t bs_field_encode(const bs_field_table_t *pTable, u32_t setting, u32_t lanes, bs_field_t *pBatch)
+{
+    for (u8_t i = 0u; i < pTable->reg_num; i++) {
+        pBatch[i].mask = 0u;
+        pBatch[i].value = 0u;
+    }
+
+    for (u8_t i = 0u; i < pTable->field_num; i++) {
+        const bs_field_desc_t *pDesc = &pTable->pFields[i];
+        u32_t value = DUMP_BITS(setting, pDesc->pos, pDesc->pos + pDesc->width - 1u);
+
+        if (pDesc->pMap) {
+            value = (value <= pDesc->last) ? pDesc->pMap[value] : BS_FIELD_INVALID;
+            if (value == BS_FIELD_INVALID) {
+                return FALSE;
+            }
+        } else if (BS_MAP_DIRECT(value, pDesc->last) == BS_MISMATCH) {
+            return FALSE;
+        }
+
+        /* Every register holds 32 / lane lanes, the lanes beyond continue in the next slot */
+        u8_t per_reg = (u8_t)(32u >> BS_CTZ(pDesc->lane));
+        bs_field_t *pField = &pBatch[pDesc->slot];
+        for (u32_t rest = lanes; rest; rest = (per_reg < 32u) ? (rest >> per_reg) : 0u, pField++) {
+            u32_t spread = _bs_field_spread((per_reg < 32u) ? (rest & MASK_BIT(per_reg)) : rest, pDesc->lane);
+            pField->mask |= spread * MASK_BIT(pDesc->lane);
+            pField->value |= spread * value;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * Commit the batch in the register order of the table, one store per register the batch touches. A register covered whole is stored
+ * without a read, the diff mode reads it and skips the store when the content is unchanged. Returns the stores issued.
+ */
+u8_t bs_field_apply(uptr_t base, const bs_field_table_t *pTable, const bs_field_t *pBatch, b_t diff)
+{
+    u8_t writes = 0u;
+
+    for (u8_t i = 0u; i < pTable->reg_num; i++) {
+        const bs_field_reg_t *pReg = &pTable->pRegs[i];
+        const bs_field_t *pField = &pBatch[pReg->slot];
+        vu32_t *pAddr = (vu32_t *)(base + pReg->offset);
+
+        if (!pField->mask) {
+            continue;
+        }
+
+        if (pReg->kind == BS_FIELD_SET_RESET) {
+            u32_t set = pField->value;
+            u32_t reset = pField->mask & ~pField->value;
+            if (diff) {
+                u32_t cur = BS_REG_RD(*(vu32_t *)(base + pReg->state));
+                set &= ~cur;
+                reset &= cur;
+            }
+            if (!(set | reset)) {
+                continue;
+            }
+            BS_REG_WR(*pAddr, set | (reset << 16u));
+        } else if ((!diff) && (pField->mask == U32_V)) {
+            BS_REG_WR(*pAddr, pField->value);
+        } else if (pTable->flags & BS_FIELD_ATOMIC) {
+            u32_t cur = bs_reg_modify(pAddr, pField->mask, pField->value);
+            if (diff && (((cur & ~pField->mask) | pField->value) == cur)) {
+                continue;
+            }
+        } else {
+            u32_t cur = BS_REG_RD(*pAddr);
+            u32_t next = (cur & ~pField->mask) | pField->value;
+            if (diff && (next == cur)) {
+                continue;
+            }
+            BS_REG_WR(*pAddr, next);
+        }
+        writes++;
+    }
+
+    return writes;
+}
+
+#endif
@@ -0,0 +1,248 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "typedef.h"
+#include "bsi_gpio.h"
+#include "bsi_gpio_verify.h"
+#include "bsi_gpio_owner.h"
+
+/**
+ * The family-independent GPIO commit. The family header supplies the register layout with GPIO_CFG_REGS in commit order, the setting
+ * encoder gpio_ctrl_1_encode and the direction fields, source/<family>/bsi_gpio.c the decoders and the family-only entry points.
+ */
+
+#if BS_GPIO_SHADOW_ENABLED
+/* The configuration images of all ports, seeded from hardware on first use */
+static gpio_cfg_regs_t g_gpio_shadow[BS_GPIO_PORT_NUM];
+static u32_t g_gpio_shadow_seeded = 0u;
+
+static void _gpio_shadow_seed(gpio_port_t port, gpio_regs_t *pGpioRegs)
+{
+    gpio_cfg_read(pGpioRegs, &g_gpio_shadow[port]);
+    g_gpio_shadow_seeded |= SET_BIT(port);
+}
+
+/* Merge the field into the shadow and store the register only when its content changes */
+#define GPIO_SHADOW_COMMIT(pRegs, pShadow, pUpdate, reg, writes)                                                                           \
+    do {                                                                                                                                   \
+        u32_t next = gpio_field_merge((pShadow)->reg, &(pUpdate)->reg);                                                                    \
+        if (next != (pShadow)->reg) {                                                                                                      \
+            (pShadow)->reg = next;                                                                                                         \
+            BS_REG_WR((pRegs)->reg, next);                                                                                                 \
+            (writes)++;                                                                                                                    \
+        }                                                                                                                                  \
+    } while (0)
+
+/* The shadow makes every commit diff-aware, the diff flag only decides whether out_ctrl is compared as well */
+static u8_t _gpio_update_commit(gpio_port_t port, gpio_regs_t *pGpioRegs, const gpio_update_t *pUpdate, b_t diff)
+{
+    if (!(g_gpio_shadow_seeded & SET_BIT(port))) {
+        _gpio_shadow_seed(port, pGpioRegs);
+    }
+    gpio_cfg_regs_t *pShadow = &g_gpio_shadow[port];
+
+    u8_t writes = gpio_out_latch(pGpioRegs, pUpdate, diff);
+#define GPIO_SHADOW_REG(reg, width, first) GPIO_SHADOW_COMMIT(pGpioRegs, pShadow, pUpdate, reg, writes);
+    GPIO_CFG_REGS(GPIO_SHADOW_REG)
+#undef GPIO_SHADOW_REG
+    BS_GPIO_HOOK(port);
+
+    return writes;
+}
+
+u32_t gpio_shadow_sync(gpio_port_t port)
+{
+    if (port >= BS_GPIO_PORT_NUM) {
+        return RESULT_INVALID_PORT;
+    }
+
+    _gpio_shadow_seed(port, (gpio_regs_t *)gpio_base_regs_addr(port));
+    return 0;
+}
+#elif BS_GPIO_FIELD_ENGINE_ENABLED
+/* The register list of g_gpio_field_table holds the same commit order, the output latch through bit_op first and ctrl last */
+static u8_t _gpio_update_commit(gpio_port_t port, gpio_regs_t *pGpioRegs, const gpio_update_t *pUpdate, b_t diff)
+{
+    u8_t writes = bs_field_apply((uptr_t)pGpioRegs, &g_gpio_field_table, (const bs_field_t *)pUpdate, diff);
+    BS_GPIO_HOOK(port);
+
+    return writes;
+}
+#else
+static u8_t _gpio_update_commit(gpio_port_t port, gpio_regs_t *pGpioRegs, const gpio_update_t *pUpdate, b_t diff)
+{
+    return gpio_update_commit(port, pGpioRegs, pUpdate, diff);
+}
+#endif
+
+static u32_t _gpio_ctrl_1_commit(gpio_port_t port, u16_t pin_mask, gpio_ctrl_1_t setting, b_t diff, u8_t *pWrites)
+{
+    if (port >= BS_GPIO_PORT_NUM) {
+        return RESULT_INVALID_PORT;
+    }
+    if (!pin_mask) {
+        return RESULT_INVALID_PIN;
+    }
+#if BS_GPIO_OWNER_CHECK_ENABLED
+    u32_t owned = gpio_owner_check_setting(port, pin_mask, setting);
+    if (owned) {
+        return owned;
+    }
+#endif
+
+    gpio_update_t update;
+    u32_t result = gpio_ctrl_1_encode(pin_mask, setting, &update);
+    if (result) {
+        return result;
+    }
+
+    gpio_regs_t *pGpioRegs = (gpio_regs_t *)gpio_base_regs_addr(port);
+    u8_t writes = _gpio_update_commit(port, pGpioRegs, &update, diff);
+#if BS_GPIO_VERIFY_ENABLED
+    gpio_verify_record(port, &update);
+#endif
+    if (pWrites) {
+        *pWrites = writes;
+    }
+
+    return 0;
+}
+
+u32_t gpio_ctrl_1_set(gpio_num_t port_pin, gpio_ctrl_1_t setting)
+{
+    u32_t result = gpio_num_check(port_pin);
+    if (result) {
+        return result;
+    }
+
+    return _gpio_ctrl_1_commit(BS_GPIO_PORT(port_pin), (u16_t)SET_BIT(BS_GPIO_PIN(port_pin)), setting, FALSE, NULL);
+}
+
+u32_t gpio_ctrl_1_set_mask(gpio_port_t port, u16_t pin_mask, gpio_ctrl_1_t setting)
+{
+    return _gpio_ctrl_1_commit(port, pin_mask, setting, FALSE, NULL);
+}
+
+/* Same as gpio_ctrl_1_set, but the registers already holding the setting are not written, pWrites receives the stores issued */
+u32_t gpio_ctrl_1_apply(gpio_num_t port_pin, gpio_ctrl_1_t setting, u8_t *pWrites)
+{
+    u32_t result = gpio_num_check(port_pin);
+    if (result) {
+        return result;
+    }
+
+    return _gpio_ctrl_1_commit(BS_GPIO_PORT(port_pin), (u16_t)SET_BIT(BS_GPIO_PIN(port_pin)), setting, TRUE, pWrites);
+}
+
+u32_t gpio_apply_images(const gpio_image_t *pImages, u8_t num)
+{
+    for (u8_t i = 0u; i < num; i++) {
+        if (pImages[i].port >= BS_GPIO_PORT_NUM) {
+            return RESULT_INVALID_PORT;
+        }
+#if BS_GPIO_OWNER_CHECK_ENABLED
+        /* Every pin of an image carries its output level, so the out_ctrl mask names the pins */
+        if (gpio_owner_check(pImages[i].port, (u16_t)pImages[i].update.out_ctrl.mask)) {
+            return RESULT_NOT_OWNED;
+        }
+#endif
+    }
+
+    for (u8_t i = 0u; i < num; i++) {
+        gpio_regs_t *pGpioRegs = (gpio_regs_t *)gpio_base_regs_addr(pImages[i].port);
+        _gpio_update_commit(pImages[i].port, pGpioRegs, &pImages[i].update, FALSE);
+#if BS_GPIO_VERIFY_ENABLED
+        gpio_verify_record(pImages[i].port, &pImages[i].update);
+#endif
+    }
+
+    return 0;
+}
+
+u32_t gpio_dir_init(gpio_dir_t *pDir, gpio_num_t port_pin)
+{
+    u32_t result = gpio_num_check(port_pin);
+    if (result) {
+        return result;
+    }
+
+    gpio_port_t port = BS_GPIO_PORT(port_pin);
+    gpio_pin_t pin = BS_GPIO_PIN(port_pin);
+
+    gpio_regs_t *pGpioRegs = (gpio_regs_t *)gpio_base_regs_addr(port);
+    pDir->pCtrl = GPIO_DIR_CTRL(pGpioRegs, pin);
+    pDir->port = port;
+#if BS_GPIO_SHADOW_ENABLED
+    if (!(g_gpio_shadow_seeded & SET_BIT(port))) {
+        _gpio_shadow_seed(port, pGpioRegs);
+    }
+    pDir->pShadowCtrl = GPIO_DIR_CTRL(&g_gpio_shadow[port], pin);
+    gpio_dir_encode(pDir, pin, *pDir->pShadowCtrl);
+#else
+    gpio_dir_encode(pDir, pin, BS_REG_RD(*pDir->pCtrl));
+#endif
+#if BS_GPIO_VERIFY_ENABLED
+    /* The helpers switch the field without a record, so it leaves the expected mask rather than reporting a false mismatch */
+    gpio_update_t release = {0};
+    GPIO_DIR_CTRL(&release, pin)->mask = pDir->ctrl_mask;
+    gpio_verify_release(port, &release);
+#endif
+
+    return 0;
+}
+
+/**
+ * Capture the configuration and the output latch of all ports, e.g. before deep sleep. The snapshot is read from the hardware, so it
+ * also holds what other code configured behind the BSI layer.
+ */
+u32_t gpio_snapshot(gpio_snapshot_t *pSnap)
+{
+    if (!pSnap) {
+        return RESULT_INVALID_ARGS;
+    }
+
+    for (gpio_port_t port = 0u; port < BS_GPIO_PORT_NUM; port++) {
+        gpio_regs_t *pGpioRegs = (gpio_regs_t *)gpio_base_regs_addr(port);
+
+        gpio_cfg_read(pGpioRegs, &pSnap->cfg[port]);
+        pSnap->out_ctrl[port] = (u16_t)(BS_REG_RD(pGpioRegs->out_ctrl) & U16_V);
+    }
+
+    return 0;
+}
+
+/**
+ * Write a snapshot back with one store per register and no read. The latch goes first through bit_op and the configuration registers
+ * follow in commit order, so a pin only becomes an output once its level and type are in place. The shadow is replaced rather than
+ * compared, as the hardware may have lost its content while asleep.
+ */
+u32_t gpio_restore(const gpio_snapshot_t *pSnap)
+{
+    if (!pSnap) {
+        return RESULT_INVALID_ARGS;
+    }
+
+    for (gpio_port_t port = 0u; port < BS_GPIO_PORT_NUM; port++) {
+        gpio_regs_t *pGpioRegs = (gpio_regs_t *)gpio_base_regs_addr(port);
+        const gpio_cfg_regs_t *pCfg = &pSnap->cfg[port];
+        u32_t octrl = pSnap->out_ctrl[port];
+
+        BS_REG_WR(pGpioRegs->bit_op, octrl | ((~octrl & U16_V) << 16u));
+#define GPIO_RESTORE_REG(reg, width, first) BS_REG_WR(pGpioRegs->reg, pCfg->reg);
+        GPIO_CFG_REGS(GPIO_RESTORE_REG)
+#undef GPIO_RESTORE_REG
+#if BS_GPIO_SHADOW_ENABLED
+        g_gpio_shadow[port] = *pCfg;
+        g_gpio_shadow_seeded |= SET_BIT(port);
+#endif
+#if BS_GPIO_VERIFY_ENABLED
+        gpio_verify_record_cfg(port, pCfg);
+#endif
+        BS_GPIO_HOOK(port);
+    }
+
+    return 0;
+}
@@ -0,0 +1,109 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "bsi_gpio_capture.h"
+
+/* The decimation keeps one of every decimation samples, 0 and 1 both keep all of them */
+u32_t gpio_capture_init(gpio_capture_t *pCap, gpio_port_t port, u16_t mask, gpio_capture_entry_t *pRing, u32_t size, u16_t decimation,
+                        b_t rle)
+{
+    if (port >= BS_GPIO_PORT_NUM) {
+        return RESULT_INVALID_PORT;
+    }
+    if ((!pCap) || (!pRing) || (!size)) {
+        return RESULT_INVALID_ARGS;
+    }
+
+    pCap->pGpioRegs = (gpio_regs_t *)gpio_base_regs_addr(port);
+    pCap->pRing = pRing;
+    pCap->size = size;
+    pCap->head = 0u;
+    pCap->used = 0u;
+    pCap->mask = mask;
+    pCap->decimation = decimation ? decimation : 1u;
+    pCap->phase = 0u;
+    pCap->rle = rle;
+
+    return 0;
+}
+
+/* Sample in_status the given times in a tight loop, every in_status read is one sample whether decimation keeps it or not */
+void gpio_capture_run(gpio_capture_t *pCap, u32_t samples)
+{
+    gpio_regs_t *pGpioRegs = pCap->pGpioRegs;
+    gpio_capture_entry_t *pRing = pCap->pRing;
+    u32_t size = pCap->size;
+    u32_t head = pCap->head;
+    u32_t used = pCap->used;
+    u16_t mask = pCap->mask;
+    u16_t decimation = pCap->decimation;
+    u16_t phase = pCap->phase;
+    b_t rle = pCap->rle;
+
+    while (samples--) {
+        u16_t level = (u16_t)BS_REG_RD(pGpioRegs->in_status) & mask;
+
+        if (++phase < decimation) {
+            continue;
+        }
+        phase = 0u;
+
+        if (rle && used) {
+            gpio_capture_entry_t *pLast = &pRing[head ? (head - 1u) : (size - 1u)];
+            if ((pLast->level == level) && (pLast->count != U16_V)) {
+                pLast->count++;
+                continue;
+            }
+        }
+
+        pRing[head].level = level;
+        pRing[head].count = 1u;
+        head = ((head + 1u) == size) ? 0u : (head + 1u);
+        if (used < size) {
+            used++;
+        }
+    }
+
+    pCap->head = head;
+    pCap->used = used;
+    pCap->phase = phase;
+}
+
+void gpio_capture_iter_init(gpio_capture_iter_t *pIter, const gpio_capture_t *pCap)
+{
+    pIter->pCap = pCap;
+    pIter->index = 0u;
+    pIter->time = 0u;
+    pIter->level = 0u;
+}
+
+/* Walk the ring from the oldest entry, the first edge reports the starting level with changed set to 0 */
+b_t gpio_capture_iter_next(gpio_capture_iter_t *pIter, gpio_capture_edge_t *pEdge)
+{
+    const gpio_capture_t *pCap = pIter->pCap;
+    u32_t first = (pCap->used < pCap->size) ? 0u : pCap->head;
+
+    while (pIter->index < pCap->used) {
+        u32_t at = first + pIter->index;
+        const gpio_capture_entry_t *pEntry = &pCap->pRing[(at >= pCap->size) ? (at - pCap->size) : at];
+        u32_t time = pIter->time;
+        u16_t changed = pEntry->level ^ pIter->level;
+        b_t start = (pIter->index == 0u);
+
+        pIter->index++;
+        pIter->time += pEntry->count;
+        pIter->level = pEntry->level;
+
+        if (start || changed) {
+            pEdge->time = time;
+            pEdge->level = pEntry->level;
+            pEdge->changed = start ? 0u : changed;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
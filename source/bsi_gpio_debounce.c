@@ -0,0 +1,20 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "bsi_gpio_debounce.h"
+
+u32_t gpio_debounce_init(gpio_debounce_t *pDeb, u16_t initial, u8_t depth)
+{
+    if ((!pDeb) || (!depth) || (depth > GPIO_DEBOUNCE_DEPTH_MAX)) {
+        return RESULT_INVALID_ARGS;
+    }
+
+    memset(pDeb, 0, sizeof(gpio_debounce_t));
+    pDeb->stable = initial;
+    pDeb->depth = depth;
+
+    return 0;
+}
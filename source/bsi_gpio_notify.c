@@ -0,0 +1,108 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "bsi_gpio_notify.h"
+
+typedef struct {
+    gpio_notify_fn_t pFn;
+    void *pArg;
+} gpio_notify_entry_t;
+
+/* The per-port edge filters and the last sample the changes are found against */
+typedef struct {
+    u16_t last;
+    u16_t rising;
+    u16_t falling;
+} gpio_notify_port_t;
+
+/* The flat callback table indexed by port * BS_GPIO_PIN_NUM + pin */
+static gpio_notify_entry_t g_gpio_notify_entry[BS_GPIO_PORT_NUM * BS_GPIO_PIN_NUM];
+static gpio_notify_port_t g_gpio_notify_port[BS_GPIO_PORT_NUM];
+
+u32_t gpio_notify_register(gpio_num_t port_pin, u8_t edges, gpio_notify_fn_t pFn, void *pArg)
+{
+    u32_t result = gpio_num_check(port_pin);
+    if (result) {
+        return result;
+    }
+    if ((!pFn) || (!(edges & GPIO_NOTIFY_BOTH))) {
+        return RESULT_INVALID_ARGS;
+    }
+
+    gpio_port_t port = BS_GPIO_PORT(port_pin);
+    gpio_pin_t pin = BS_GPIO_PIN(port_pin);
+    gpio_notify_port_t *pPort = &g_gpio_notify_port[port];
+    gpio_notify_entry_t *pEntry = &g_gpio_notify_entry[port * BS_GPIO_PIN_NUM + pin];
+    u16_t bit = (u16_t)SET_BIT(pin);
+
+    pEntry->pFn = pFn;
+    pEntry->pArg = pArg;
+    pPort->rising = (edges & GPIO_NOTIFY_RISING) ? (pPort->rising | bit) : (pPort->rising & (u16_t)~bit);
+    pPort->falling = (edges & GPIO_NOTIFY_FALLING) ? (pPort->falling | bit) : (pPort->falling & (u16_t)~bit);
+
+    return 0;
+}
+
+u32_t gpio_notify_unregister(gpio_num_t port_pin)
+{
+    u32_t result = gpio_num_check(port_pin);
+    if (result) {
+        return result;
+    }
+
+    gpio_port_t port = BS_GPIO_PORT(port_pin);
+    gpio_pin_t pin = BS_GPIO_PIN(port_pin);
+    gpio_notify_port_t *pPort = &g_gpio_notify_port[port];
+    u16_t bit = (u16_t)SET_BIT(pin);
+
+    pPort->rising &= (u16_t)~bit;
+    pPort->falling &= (u16_t)~bit;
+    g_gpio_notify_entry[port * BS_GPIO_PIN_NUM + pin].pFn = NULL;
+
+    return 0;
+}
+
+/* Take the current level as the reference without notifying, e.g. after the pins were configured */
+u32_t gpio_notify_sync(gpio_port_t port)
+{
+    if (port >= BS_GPIO_PORT_NUM) {
+        return RESULT_INVALID_PORT;
+    }
+
+    g_gpio_notify_port[port].last = gpio_port_read(port);
+    return 0;
+}
+
+/* Diff the sample against the last one and call the handlers of the changed pins only, lowest pin first */
+u32_t gpio_notify_feed(gpio_port_t port, u16_t sample)
+{
+    if (port >= BS_GPIO_PORT_NUM) {
+        return RESULT_INVALID_PORT;
+    }
+
+    gpio_notify_port_t *pPort = &g_gpio_notify_port[port];
+    u16_t changed = sample ^ pPort->last;
+    u16_t pending = changed & ((sample & pPort->rising) | ((u16_t)~sample & pPort->falling));
+    const gpio_notify_entry_t *pEntry = &g_gpio_notify_entry[port * BS_GPIO_PIN_NUM];
+
+    pPort->last = sample;
+    while (pending) {
+        u8_t pin = BS_CTZ(pending);
+        pending &= (u16_t)(pending - 1u);
+        pEntry[pin].pFn(BS_GPIO_NUM(port, pin), FLAG(sample & SET_BIT(pin)), pEntry[pin].pArg);
+    }
+
+    return 0;
+}
+
+u32_t gpio_notify_poll(gpio_port_t port)
+{
+    if (port >= BS_GPIO_PORT_NUM) {
+        return RESULT_INVALID_PORT;
+    }
+
+    return gpio_notify_feed(port, gpio_port_read(port));
+}
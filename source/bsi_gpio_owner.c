@@ -0,0 +1,191 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "bsi_gpio_owner.h"
+
+/* The claimed pins of every port and the pins each owner holds */
+static u16_t g_gpio_claimed[BS_GPIO_PORT_NUM];
+static u16_t g_gpio_owner[BS_GPIO_OWNER_NUM][BS_GPIO_PORT_NUM];
+
+/* The pins reserved for an alternate function and their function numbers, one nibble per pin as in alt_fun_0/alt_fun_1 */
+static u16_t g_gpio_af_claimed[BS_GPIO_PORT_NUM];
+static u32_t g_gpio_af[BS_GPIO_PORT_NUM][2];
+
+/* The owner the configuration calls run on behalf of */
+static gpio_owner_t g_gpio_owner_selected = GPIO_OWNER_NONE;
+
+/* The owner of the first pin in the mask, only walked to report a conflict */
+static gpio_owner_t _gpio_owner_find(gpio_port_t port, u16_t pin_mask)
+{
+    for (gpio_owner_t owner = 0u; owner < BS_GPIO_OWNER_NUM; owner++) {
+        if (g_gpio_owner[owner][port] & pin_mask) {
+            return owner;
+        }
+    }
+    return GPIO_OWNER_NONE;
+}
+
+/* Claim all pins of the mask or none, pins the owner already holds are accepted again, pHolder receives the owner blocking the claim */
+u32_t gpio_claim_mask(gpio_port_t port, u16_t pin_mask, gpio_owner_t owner, gpio_owner_t *pHolder)
+{
+    if (port >= BS_GPIO_PORT_NUM) {
+        return RESULT_INVALID_PORT;
+    }
+    if ((!pin_mask) || (owner >= BS_GPIO_OWNER_NUM)) {
+        return RESULT_INVALID_ARGS;
+    }
+
+    u16_t *pOwned = &g_gpio_owner[owner][port];
+    u16_t taken = g_gpio_claimed[port] & pin_mask & (u16_t)~(*pOwned);
+    if (taken) {
+        if (pHolder) {
+            *pHolder = _gpio_owner_find(port, taken);
+        }
+        return RESULT_BUSY;
+    }
+
+    g_gpio_claimed[port] |= pin_mask;
+    *pOwned |= pin_mask;
+    return 0;
+}
+
+u32_t gpio_claim(gpio_num_t port_pin, gpio_owner_t owner)
+{
+    u32_t result = gpio_num_check(port_pin);
+    if (result) {
+        return result;
+    }
+
+    return gpio_claim_mask(BS_GPIO_PORT(port_pin), (u16_t)SET_BIT(BS_GPIO_PIN(port_pin)), owner, NULL);
+}
+
+/**
+ * Claim the pin and reserve one alternate function number for it. Reserving another number for a pin the owner already holds that way
+ * is a conflict as well, the pin has to be released first.
+ */
+u32_t gpio_claim_af(gpio_num_t port_pin, gpio_owner_t owner, u8_t alternate)
+{
+    u32_t result = gpio_num_check(port_pin);
+    if (result) {
+        return result;
+    }
+    if (alternate > GPIO_CTRL_1(CTRL_AF_FUNC_15)) {
+        return RESULT_INVALID_ARGS;
+    }
+
+    gpio_port_t port = BS_GPIO_PORT(port_pin);
+    gpio_pin_t pin = BS_GPIO_PIN(port_pin);
+    u32_t *pAf = &g_gpio_af[port][pin >> 3u];
+    u32_t shift = (pin & 7u) * 4u;
+
+    if ((g_gpio_af_claimed[port] & SET_BIT(pin)) && (((*pAf >> shift) & MASK_BIT(4)) != alternate)) {
+        return RESULT_BUSY;
+    }
+    result = gpio_claim_mask(port, (u16_t)SET_BIT(pin), owner, NULL);
+    if (result) {
+        return result;
+    }
+
+    *pAf = (*pAf & ~(MASK_BIT(4) << shift)) | ((u32_t)alternate << shift);
+    g_gpio_af_claimed[port] |= (u16_t)SET_BIT(pin);
+    return 0;
+}
+
+/* Release all pins of the mask or none, every pin must be held by the owner */
+u32_t gpio_release_mask(gpio_port_t port, u16_t pin_mask, gpio_owner_t owner)
+{
+    if (port >= BS_GPIO_PORT_NUM) {
+        return RESULT_INVALID_PORT;
+    }
+    if ((!pin_mask) || (owner >= BS_GPIO_OWNER_NUM)) {
+        return RESULT_INVALID_ARGS;
+    }
+
+    u16_t *pOwned = &g_gpio_owner[owner][port];
+    if ((*pOwned & pin_mask) != pin_mask) {
+        return RESULT_NOT_OWNED;
+    }
+
+    *pOwned &= (u16_t)~pin_mask;
+    g_gpio_claimed[port] &= (u16_t)~pin_mask;
+    g_gpio_af_claimed[port] &= (u16_t)~pin_mask;
+    return 0;
+}
+
+u32_t gpio_release(gpio_num_t port_pin, gpio_owner_t owner)
+{
+    u32_t result = gpio_num_check(port_pin);
+    if (result) {
+        return result;
+    }
+
+    return gpio_release_mask(BS_GPIO_PORT(port_pin), (u16_t)SET_BIT(BS_GPIO_PIN(port_pin)), owner);
+}
+
+gpio_owner_t gpio_owner_of(gpio_num_t port_pin)
+{
+    if (gpio_num_check(port_pin)) {
+        return GPIO_OWNER_NONE;
+    }
+
+    return _gpio_owner_find(BS_GPIO_PORT(port_pin), (u16_t)SET_BIT(BS_GPIO_PIN(port_pin)));
+}
+
+/* An invalid port reads as no pin claimed */
+u16_t gpio_claimed(gpio_port_t port)
+{
+    if (port >= BS_GPIO_PORT_NUM) {
+        return 0u;
+    }
+    return g_gpio_claimed[port];
+}
+
+/* Select the owner of the following configuration calls and return the previous one, GPIO_OWNER_NONE accepts any claimed pin */
+gpio_owner_t gpio_owner_select(gpio_owner_t owner)
+{
+    gpio_owner_t previous = g_gpio_owner_selected;
+
+    g_gpio_owner_selected = (owner < BS_GPIO_OWNER_NUM) ? owner : GPIO_OWNER_NONE;
+    return previous;
+}
+
+/* Every pin of the mask must be held by the selected owner, or by any owner when none is selected */
+u32_t gpio_owner_check(gpio_port_t port, u16_t pin_mask)
+{
+    if (port >= BS_GPIO_PORT_NUM) {
+        return RESULT_INVALID_PORT;
+    }
+
+    gpio_owner_t owner = g_gpio_owner_selected;
+    u16_t held = (owner == GPIO_OWNER_NONE) ? g_gpio_claimed[port] : g_gpio_owner[owner][port];
+    if ((held & pin_mask) != pin_mask) {
+        return RESULT_NOT_OWNED;
+    }
+    return 0;
+}
+
+/* The ownership check plus the alternate function reserved for the pins, compared on all of them at once in the nibble lanes */
+u32_t gpio_owner_check_setting(gpio_port_t port, u16_t pin_mask, gpio_ctrl_1_t setting)
+{
+    u32_t result = gpio_owner_check(port, pin_mask);
+    if (result) {
+        return result;
+    }
+    if (CB(setting, in_out) != GPIO_CTRL_1(CTRL_AFIO)) {
+        return 0;
+    }
+
+    u16_t reserved = pin_mask & g_gpio_af_claimed[port];
+    u32_t lane_lo = gpio_lane_4((u8_t)(reserved & 0xFFu));
+    u32_t lane_hi = gpio_lane_4((u8_t)(reserved >> 8u));
+    u32_t alternate = CB(setting, alternate);
+
+    if (((g_gpio_af[port][0] ^ (lane_lo * alternate)) & (lane_lo * MASK_BIT(4))) ||
+        ((g_gpio_af[port][1] ^ (lane_hi * alternate)) & (lane_hi * MASK_BIT(4)))) {
+        return RESULT_BUSY;
+    }
+    return 0;
+}
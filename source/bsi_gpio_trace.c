@@ -0,0 +1,80 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "bsi_gpio_trace.h"
+
+#if BS_GPIO_TRACE_ENABLED
+
+BS_STATIC_ASSERT((BS_GPIO_TRACE_SIZE & (BS_GPIO_TRACE_SIZE - 1u)) == 0u);
+
+static gpio_trace_entry_t g_gpio_trace[BS_GPIO_TRACE_SIZE];
+static vu32_t g_gpio_trace_count = 0u;
+
+/* Reserve the next slot, the count only ever grows so a slot is never handed out twice until the ring wraps */
+static inline u32_t _gpio_trace_claim(void)
+{
+#if defined(__CC_ARM)
+    u32_t count;
+    do {
+        count = __ldrex(&g_gpio_trace_count);
+    } while (__strex(count + 1u, &g_gpio_trace_count));
+    return count;
+#elif defined(__ICCARM__)
+    u32_t count;
+    do {
+        count = __LDREX((unsigned long *)&g_gpio_trace_count);
+    } while (__STREX(count + 1u, (unsigned long *)&g_gpio_trace_count));
+    return count;
+#else
+    return __atomic_fetch_add(&g_gpio_trace_count, 1u, __ATOMIC_RELAXED);
+#endif
+}
+
+/* The stores outside the GPIO ports, e.g. to EXTI, are not recorded */
+void gpio_trace_record(uptr_t addr, u32_t value)
+{
+    for (gpio_port_t port = 0u; port < BS_GPIO_PORT_NUM; port++) {
+        uptr_t offset = addr - gpio_base_regs_addr(port);
+        if (offset < sizeof(gpio_regs_t)) {
+            u32_t count = _gpio_trace_claim();
+            gpio_trace_entry_t *pEntry = &g_gpio_trace[count & (BS_GPIO_TRACE_SIZE - 1u)];
+
+            pEntry->timestamp = BS_TIMESTAMP();
+            pEntry->value = value;
+            pEntry->seq = (u16_t)count;
+            pEntry->port = port;
+            pEntry->offset = (u8_t)offset;
+            return;
+        }
+    }
+}
+
+/* Copy the latest recorded stores oldest first, at most max of them, and return the number copied */
+u32_t gpio_trace_read(gpio_trace_entry_t *pEntries, u32_t max)
+{
+    if (!pEntries) {
+        return 0u;
+    }
+
+    u32_t count = g_gpio_trace_count;
+    u32_t num = (count < BS_GPIO_TRACE_SIZE) ? count : BS_GPIO_TRACE_SIZE;
+    if (num > max) {
+        num = max;
+    }
+
+    u32_t first = count - num;
+    for (u32_t i = 0u; i < num; i++) {
+        pEntries[i] = g_gpio_trace[(first + i) & (BS_GPIO_TRACE_SIZE - 1u)];
+    }
+    return num;
+}
+
+void gpio_trace_reset(void)
+{
+    g_gpio_trace_count = 0u;
+}
+
+#endif
@@ -0,0 +1,188 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "bsi_gpio_verify.h"
+
+#if BS_GPIO_VERIFY_ENABLED
+
+/* The expected content of the configuration registers, the mask covers the fields written through the BSI layer */
+typedef struct {
+#define GPIO_VERIFY_MEMBER(reg, width, first) gpio_field_t reg;
+    GPIO_CFG_REGS(GPIO_VERIFY_MEMBER)
+#undef GPIO_VERIFY_MEMBER
+} gpio_verify_port_t;
+
+static gpio_verify_port_t g_gpio_verify[BS_GPIO_PORT_NUM];
+static u32_t g_gpio_verify_crc[BS_GPIO_PORT_NUM];
+
+/* The reflected 0xEDB88320 polynomial one nibble at a time */
+static const u32_t g_gpio_verify_crc_table[16] = {
+    0x00000000u, 0x1DB71064u, 0x3B6E20C8u, 0x26D930ACu, 0x76DC4190u, 0x6B6B51F4u, 0x4DB26158u, 0x5005713Cu,
+    0xEDB88320u, 0xF00F9344u, 0xD6D6A3E8u, 0xCB61B38Cu, 0x9B64C2B0u, 0x86D3D2D4u, 0xA00AE278u, 0xBDBDF21Cu,
+};
+
+/* The CRC starts from zero without the final inversion, so the zeroed record of a port never configured matches its zeroed CRC */
+static u32_t _gpio_verify_crc(const gpio_verify_port_t *pExpect)
+{
+    const u32_t *pWord = (const u32_t *)pExpect;
+    u32_t crc = 0u;
+
+    for (u32_t i = 0u; i < (sizeof(gpio_verify_port_t) / sizeof(u32_t)); i++) {
+        crc ^= pWord[i];
+        for (u8_t n = 0u; n < 8u; n++) {
+            crc = (crc >> 4u) ^ g_gpio_verify_crc_table[crc & 0xFu];
+        }
+    }
+    return crc;
+}
+
+/* Turn the differing register bits into the pins owning them */
+static inline u16_t _gpio_verify_pins(u32_t diff, u8_t width, u8_t first)
+{
+    if (width == 1u) {
+        return (u16_t)(diff & U16_V);
+    }
+    if (width == 2u) {
+        return gpio_lane_2_pins(diff);
+    }
+    return (u16_t)((u16_t)gpio_lane_4_pins(diff) << first);
+}
+
+void gpio_verify_record(gpio_port_t port, const gpio_update_t *pUpdate)
+{
+    if (port >= BS_GPIO_PORT_NUM) {
+        return;
+    }
+
+    gpio_verify_port_t *pExpect = &g_gpio_verify[port];
+#define GPIO_VERIFY_MERGE(reg, width, first)                                                                                               \
+    pExpect->reg.value = gpio_field_merge(pExpect->reg.value, &pUpdate->reg);                                                              \
+    pExpect->reg.mask |= pUpdate->reg.mask;
+    GPIO_CFG_REGS(GPIO_VERIFY_MERGE)
+#undef GPIO_VERIFY_MERGE
+    g_gpio_verify_crc[port] = _gpio_verify_crc(pExpect);
+}
+
+/* A whole-register write such as gpio_restore makes every field of the port expected */
+void gpio_verify_record_cfg(gpio_port_t port, const gpio_cfg_regs_t *pCfg)
+{
+    if (port >= BS_GPIO_PORT_NUM) {
+        return;
+    }
+
+    gpio_verify_port_t *pExpect = &g_gpio_verify[port];
+#define GPIO_VERIFY_FULL(reg, width, first)                                                                                                \
+    pExpect->reg.mask = U32_V;                                                                                                             \
+    pExpect->reg.value = pCfg->reg;
+    GPIO_CFG_REGS(GPIO_VERIFY_FULL)
+#undef GPIO_VERIFY_FULL
+    g_gpio_verify_crc[port] = _gpio_verify_crc(pExpect);
+}
+
+/* Stop expecting the fields named by the release masks, e.g. a direction field switched by gpio_dir_in/gpio_dir_out */
+void gpio_verify_release(gpio_port_t port, const gpio_update_t *pRelease)
+{
+    if (port >= BS_GPIO_PORT_NUM) {
+        return;
+    }
+
+    gpio_verify_port_t *pExpect = &g_gpio_verify[port];
+#define GPIO_VERIFY_RELEASE(reg, width, first)                                                                                             \
+    pExpect->reg.mask &= ~pRelease->reg.mask;                                                                                              \
+    pExpect->reg.value &= ~pRelease->reg.mask;
+    GPIO_CFG_REGS(GPIO_VERIFY_RELEASE)
+#undef GPIO_VERIFY_RELEASE
+    g_gpio_verify_crc[port] = _gpio_verify_crc(pExpect);
+}
+
+/* The configuration registers in record order, a step of gpio_verify_step compares one of them */
+typedef struct {
+    u8_t offset;
+    u8_t width;
+    u8_t first;
+} gpio_verify_reg_t;
+
+static const gpio_verify_reg_t g_gpio_verify_regs[] = {
+#define GPIO_VERIFY_REG(reg, width, first) {(u8_t)offsetof(gpio_regs_t, reg), width, first},
+    GPIO_CFG_REGS(GPIO_VERIFY_REG)
+#undef GPIO_VERIFY_REG
+};
+
+#define GPIO_VERIFY_REG_NUM (DIMOF(g_gpio_verify_regs))
+
+/* The record holds one field per register in the same order, so a step indexes it like the table */
+BS_STATIC_ASSERT(sizeof(gpio_verify_port_t) == (GPIO_VERIFY_REG_NUM * sizeof(gpio_field_t)));
+
+static u32_t g_gpio_verify_next = 0u;
+
+/* Compare one register of the port against its record and turn the differing bits into the pins owning them */
+static u16_t _gpio_verify_reg(gpio_port_t port, u32_t index)
+{
+    const gpio_verify_reg_t *pReg = &g_gpio_verify_regs[index];
+    const gpio_field_t *pExpect = &((const gpio_field_t *)&g_gpio_verify[port])[index];
+
+    if (!pExpect->mask) {
+        return 0u;
+    }
+
+    u32_t cur = BS_REG_RD(*(vu32_t *)(gpio_base_regs_addr(port) + pReg->offset));
+    return _gpio_verify_pins((cur ^ pExpect->value) & pExpect->mask, pReg->width, pReg->first);
+}
+
+/* A difference is only trusted once the record passes its CRC, a failing record reports all pins and RESULT_CORRUPTED instead */
+static u32_t _gpio_verify_result(gpio_port_t port, u16_t pins, u16_t *pPins)
+{
+    u32_t result = 0u;
+
+    if (pins) {
+        result = RESULT_MISMATCH;
+        if (_gpio_verify_crc(&g_gpio_verify[port]) != g_gpio_verify_crc[port]) {
+            pins = U16_V;
+            result = RESULT_CORRUPTED;
+        }
+    }
+    if (pPins) {
+        *pPins = pins;
+    }
+    return result;
+}
+
+/* Check every register of one port, pPins receives the pins whose fields differ from the record */
+u32_t gpio_verify_port(gpio_port_t port, u16_t *pPins)
+{
+    if (port >= BS_GPIO_PORT_NUM) {
+        return RESULT_INVALID_PORT;
+    }
+
+    u16_t pins = 0u;
+    for (u32_t index = 0u; index < GPIO_VERIFY_REG_NUM; index++) {
+        pins |= _gpio_verify_reg(port, index);
+    }
+    return _gpio_verify_result(port, pins, pPins);
+}
+
+#if defined(BS_HOST_ENABLED)
+/* The record of a port as its fields in register order, the host tests corrupt it to reach RESULT_CORRUPTED */
+gpio_field_t *bs_host_verify_record(gpio_port_t port)
+{
+    return (port < BS_GPIO_PORT_NUM) ? (gpio_field_t *)&g_gpio_verify[port] : NULL;
+}
+#endif
+
+/* Check one register per call, walking the registers of a port and then the ports round robin, pPort receives the port checked */
+u32_t gpio_verify_step(gpio_port_t *pPort, u16_t *pPins)
+{
+    u32_t step = g_gpio_verify_next;
+    gpio_port_t port = (gpio_port_t)(step / GPIO_VERIFY_REG_NUM);
+
+    g_gpio_verify_next = (step + 1u) % (GPIO_VERIFY_REG_NUM * BS_GPIO_PORT_NUM);
+    if (pPort) {
+        *pPort = port;
+    }
+    return _gpio_verify_result(port, _gpio_verify_reg(port, step % GPIO_VERIFY_REG_NUM), pPins);
+}
+
+#endif
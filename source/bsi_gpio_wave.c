@@ -0,0 +1,119 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "bsi_gpio_wave.h"
+
+/**
+ * Compile the pin timelines of one port into runs of bit_op words. Every word drives all the pins of the wave, the high ones through the
+ * set half and the low ones through the reset half, so a word is idempotent and consecutive slots with the same word merge into one run.
+ * pStepNum carries the capacity of pSteps in and the compiled runs out.
+ */
+u32_t gpio_wave_compile(const gpio_wave_pin_t *pPins, u8_t pin_num, u32_t length, gpio_wave_step_t *pSteps, u32_t *pStepNum)
+{
+    u16_t cursor[BS_GPIO_PIN_NUM] = {0u};
+    u16_t mask = 0u;
+    u16_t state = 0u;
+
+    if ((!pPins) || (!pSteps) || (!pStepNum) || (!length) || (pin_num > BS_GPIO_PIN_NUM)) {
+        return RESULT_INVALID_ARGS;
+    }
+
+    for (u8_t i = 0u; i < pin_num; i++) {
+        if (pPins[i].pin >= BS_GPIO_PIN_NUM) {
+            return RESULT_INVALID_PIN;
+        }
+        u16_t bit = (u16_t)SET_BIT(pPins[i].pin);
+        if (mask & bit) {
+            return RESULT_INVALID_PIN;
+        }
+        mask |= bit;
+        if (pPins[i].initial) {
+            state |= bit;
+        }
+    }
+
+    u32_t capacity = *pStepNum;
+    u32_t steps = 0u;
+    u32_t slot = 0u;
+
+    while (slot < length) {
+        /* Apply the edges landing on this slot, then find the next slot any pin changes at */
+        u32_t next = length;
+        for (u8_t i = 0u; i < pin_num; i++) {
+            const gpio_wave_pin_t *pPin = &pPins[i];
+            while ((cursor[i] < pPin->num) && (pPin->pEdges[cursor[i]].slot <= slot)) {
+                if (pPin->pEdges[cursor[i]].level) {
+                    state |= (u16_t)SET_BIT(pPin->pin);
+                } else {
+                    state &= (u16_t)~SET_BIT(pPin->pin);
+                }
+                cursor[i]++;
+            }
+            if ((cursor[i] < pPin->num) && (pPin->pEdges[cursor[i]].slot < next)) {
+                next = pPin->pEdges[cursor[i]].slot;
+            }
+        }
+
+        u32_t word = (u32_t)(state & mask) | ((u32_t)(mask & (u16_t)~state) << 16u);
+        if (steps && (pSteps[steps - 1u].bit_op == word)) {
+            pSteps[steps - 1u].slots += next - slot;
+        } else {
+            if (steps >= capacity) {
+                return RESULT_NO_SPACE;
+            }
+            pSteps[steps].bit_op = word;
+            pSteps[steps].slots = next - slot;
+            steps++;
+        }
+        slot = next;
+    }
+
+    *pStepNum = steps;
+    return 0;
+}
+
+/* Expand the runs into one bit_op word per time slot, the buffer a timer-triggered DMA streams into bit_op */
+u32_t gpio_wave_expand(const gpio_wave_step_t *pSteps, u32_t step_num, u32_t *pWords, u32_t *pWordNum)
+{
+    if ((!pSteps) || (!pWords) || (!pWordNum)) {
+        return RESULT_INVALID_ARGS;
+    }
+
+    u32_t capacity = *pWordNum;
+    u32_t words = 0u;
+
+    for (u32_t i = 0u; i < step_num; i++) {
+        if (pSteps[i].slots > (capacity - words)) {
+            return RESULT_NO_SPACE;
+        }
+        for (u32_t n = 0u; n < pSteps[i].slots; n++) {
+            pWords[words++] = pSteps[i].bit_op;
+        }
+    }
+
+    *pWordNum = words;
+    return 0;
+}
+
+/* Play the runs from the CPU, one bit_op store per run followed by the wait of the run length */
+u32_t gpio_wave_play(gpio_port_t port, const gpio_wave_step_t *pSteps, u32_t step_num, gpio_wave_wait_t pWait)
+{
+    if (port >= BS_GPIO_PORT_NUM) {
+        return RESULT_INVALID_PORT;
+    }
+    if ((!pSteps) || (!pWait)) {
+        return RESULT_INVALID_ARGS;
+    }
+
+    gpio_regs_t *pGpioRegs = (gpio_regs_t *)gpio_base_regs_addr(port);
+    for (u32_t i = 0u; i < step_num; i++) {
+        BS_REG_WR(pGpioRegs->bit_op, pSteps[i].bit_op);
+        BS_GPIO_HOOK(port);
+        pWait(pSteps[i].slots);
+    }
+
+    return 0;
+}
@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "typedef.h"
+#include "bsi_gpio.h"
+
+/* The nibble macros of bsi_gpio_regs.h compare the settings by their numeric encoding */
+BS_STATIC_ASSERT((CTRL_INPUT == 0u) && (CTRL_OUTPUT == 1u) && (CTRL_AFIO == 2u) && (CTRL_ANALOG == 3u));
+BS_STATIC_ASSERT((CTRL_FLOAT == 0u) && (CTRL_PULL_UP == 1u) && (CTRL_PULL_DOWN == 2u));
+BS_STATIC_ASSERT((CTRL_PUSH_PULL == 0u) && (CTRL_OPEN_DRAIN == 1u));
+BS_STATIC_ASSERT((CTRL_SPEED_LEVEL_0 == 0u) && (CTRL_SPEED_LEVEL_3 == 3u));
+BS_STATIC_ASSERT((CTRL_LOW == 0u) && (CTRL_HIGH == 1u));
+BS_STATIC_ASSERT((CTRL_AF_FUNC_0 == 0u) && (CTRL_AF_FUNC_15 == 15u));
+
+/* The setting of every mode nibble without the out_ctrl dependent parts, a pulled input decodes as pull-down and the speed level 3 as 2 */
+static const u16_t g_gpio_ctl_decode[16] = {
+    0x003u, 0x009u, 0x001u, 0x011u, 0x000u, 0x00Du, 0x005u, 0x015u, 0x040u, 0x00Au, 0x002u, 0x012u, 0x000u, 0x00Eu, 0x006u, 0x016u,
+};
+
+/* The out_ctrl bit is the level of every pin, and the pull direction of a pulled input which flips pull-down (2) into pull-up (1) */
+static inline u32_t _gpio_ctl_decode(u32_t ctl, u32_t out)
+{
+    u32_t value = g_gpio_ctl_decode[ctl] | (out << GPIO_CTRL_1_POS_OUT_SET);
+
+    if ((ctl == 0x8u) && out) {
+        value ^= (u32_t)(CTRL_PULL_UP ^ CTRL_PULL_DOWN) << GPIO_CTRL_1_POS_UP_DOWN;
+    }
+    return value;
+}
+
+/* Read the port registers once and decode the settings of all 16 pins into pSettings, the alternate function always reads 0 */
+u32_t gpio_port_decode(gpio_port_t port, gpio_ctrl_1_t *pSettings)
+{
+    if (port >= BS_GPIO_PORT_NUM) {
+        return RESULT_INVALID_PORT;
+    }
+    if (!pSettings) {
+        return RESULT_INVALID_ARGS;
+    }
+
+    gpio_regs_t *pGpioRegs = (gpio_regs_t *)gpio_base_regs_addr(port);
+    u32_t ctl_0 = BS_REG_RD(pGpioRegs->ctl_0);
+    u32_t ctl_1 = BS_REG_RD(pGpioRegs->ctl_1);
+    u32_t octrl = BS_REG_RD(pGpioRegs->out_ctrl);
+
+    for (u8_t i = 0u; i < 8u; i++) {
+        pSettings[i].value = _gpio_ctl_decode(ctl_0 & 0xFu, octrl & 1u);
+        pSettings[i + 8u].value = _gpio_ctl_decode(ctl_1 & 0xFu, (octrl >> 8u) & 1u);
+        ctl_0 >>= 4u;
+        ctl_1 >>= 4u;
+        octrl >>= 1u;
+    }
+    return 0;
+}
+
+/* Read back the current setting of one pin */
+u32_t gpio_ctrl_1_get(gpio_num_t port_pin, gpio_ctrl_1_t *pSetting)
+{
+    u32_t result = gpio_num_check(port_pin);
+    if (result) {
+        return result;
+    }
+    if (!pSetting) {
+        return RESULT_INVALID_ARGS;
+    }
+
+    gpio_regs_t *pGpioRegs = (gpio_regs_t *)gpio_base_regs_addr(BS_GPIO_PORT(port_pin));
+    gpio_pin_t pin = BS_GPIO_PIN(port_pin);
+    u32_t ctl = BS_REG_RD(*GPIO_DIR_CTRL(pGpioRegs, pin));
+
+    pSetting->value = _gpio_ctl_decode((ctl >> ((pin & 7u) * 4u)) & 0xFu, (BS_REG_RD(pGpioRegs->out_ctrl) >> pin) & 1u);
+    return 0;
+}
+
+/* Turn every pin outside pUsed[port] into an analog pin, the all-zero nibble, gpio_restore then applies the parked image */
+u32_t gpio_snapshot_park(gpio_snapshot_t *pSnap, const u16_t *pUsed)
+{
+    if ((!pSnap) || (!pUsed)) {
+        return RESULT_INVALID_ARGS;
+    }
+
+    for (gpio_port_t port = 0u; port < BS_GPIO_PORT_NUM; port++) {
+        u16_t unused = (u16_t)~pUsed[port];
+
+        pSnap->cfg[port].ctl_0 &= ~(gpio_lane_4((u8_t)(unused & 0xFFu)) * MASK_BIT(4));
+        pSnap->cfg[port].ctl_1 &= ~(gpio_lane_4((u8_t)(unused >> 8u)) * MASK_BIT(4));
+    }
+
+    return 0;
+}
@@ -4,95 +4,160 @@
  * This source code is licensed under the MIT license found in the
  * LICENSE file in the root directory of this source tree.
  **/
-#include "gd32f30x_gpio.h"
 #include "typedef.h"
 #include "bsi_gpio.h"
 
-u32_t gpio_ctrl_1_set(gpio_num_t port_pin, gpio_ctrl_1_t setting)
+/* The setting enumerations carry the register encoding directly, which lets the encoder decode them with BS_MAP_DIRECT */
+BS_STATIC_ASSERT((CTRL_INPUT == 0u) && (CTRL_OUTPUT == 1u) && (CTRL_AFIO == 2u) && (CTRL_ANALOG == 3u));
+BS_STATIC_ASSERT((CTRL_FLOAT == 0u) && (CTRL_PULL_UP == 1u) && (CTRL_PULL_DOWN == 2u));
+BS_STATIC_ASSERT((CTRL_PUSH_PULL == 0u) && (CTRL_OPEN_DRAIN == 1u));
+BS_STATIC_ASSERT((CTRL_SPEED_LEVEL_0 == 0u) && (CTRL_SPEED_LEVEL_3 == 3u));
+BS_STATIC_ASSERT((CTRL_LOW == 0u) && (CTRL_HIGH == 1u));
+BS_STATIC_ASSERT((CTRL_AF_FUNC_0 == 0u) && (CTRL_AF_FUNC_15 == 15u));
+
+#if BS_GPIO_FIELD_ENGINE_ENABLED
+/* The ctrl_1_b_t fields and the gpio_update_t slot each of them programs for every selected pin */
+static const bs_field_desc_t g_gpio_fields[] = {
+    {NULL, 0u, 2u, 2u, CTRL_ANALOG, BS_FIELD_SLOT(gpio_update_t, ctrl)},
+    {NULL, GPIO_CTRL_1_POS_OUT_MODE, 1u, 1u, CTRL_OPEN_DRAIN, BS_FIELD_SLOT(gpio_update_t, out_mode)},
+    {NULL, GPIO_CTRL_1_POS_SPEED, 2u, 2u, CTRL_SPEED_LEVEL_3, BS_FIELD_SLOT(gpio_update_t, out_speed)},
+    {NULL, GPIO_CTRL_1_POS_UP_DOWN, 2u, 2u, CTRL_PULL_DOWN, BS_FIELD_SLOT(gpio_update_t, up_down)},
+    {NULL, GPIO_CTRL_1_POS_OUT_SET, 1u, 1u, CTRL_HIGH, BS_FIELD_SLOT(gpio_update_t, out_ctrl)},
+    {NULL, GPIO_CTRL_1_POS_ALTERNATE, 4u, 4u, CTRL_AF_FUNC_15, BS_FIELD_SLOT(gpio_update_t, alt_fun_0)},
+};
+
+/* The commit order: the output latch through bit_op first, so no glitch appears on the pins, and the mode switch in ctrl last */
+static const bs_field_reg_t g_gpio_field_regs[] = {
+    {BS_FIELD_SLOT(gpio_update_t, out_ctrl), BS_FIELD_SET_RESET, BS_FIELD_OFFSET(gpio_regs_t, bit_op),
+     BS_FIELD_OFFSET(gpio_regs_t, out_ctrl)},
+    {BS_FIELD_SLOT(gpio_update_t, up_down), BS_FIELD_RMW, BS_FIELD_OFFSET(gpio_regs_t, up_down), 0u},
+    {BS_FIELD_SLOT(gpio_update_t, out_mode), BS_FIELD_RMW, BS_FIELD_OFFSET(gpio_regs_t, out_mode), 0u},
+    {BS_FIELD_SLOT(gpio_update_t, out_speed), BS_FIELD_RMW, BS_FIELD_OFFSET(gpio_regs_t, out_speed), 0u},
+    {BS_FIELD_SLOT(gpio_update_t, alt_fun_0), BS_FIELD_RMW, BS_FIELD_OFFSET(gpio_regs_t, alt_fun_0), 0u},
+    {BS_FIELD_SLOT(gpio_update_t, alt_fun_1), BS_FIELD_RMW, BS_FIELD_OFFSET(gpio_regs_t, alt_fun_1), 0u},
+    {BS_FIELD_SLOT(gpio_update_t, ctrl), BS_FIELD_RMW, BS_FIELD_OFFSET(gpio_regs_t, ctrl), 0u},
+};
+
+const bs_field_table_t g_gpio_field_table = {
+    g_gpio_fields,
+    g_gpio_field_regs,
+    DIMOF(g_gpio_fields),
+    DIMOF(g_gpio_field_regs),
+    BS_GPIO_ATOMIC_ENABLED ? BS_FIELD_ATOMIC : 0u,
+};
+
+/* The field engine treats gpio_update_t as one slot per register, the 4-bit lanes of pins 8-15 continue in alt_fun_1 */
+BS_STATIC_ASSERT(sizeof(gpio_update_t) == (DIMOF(g_gpio_field_regs) * sizeof(bs_field_t)));
+BS_STATIC_ASSERT(BS_FIELD_SLOT(gpio_update_t, alt_fun_1) == (BS_FIELD_SLOT(gpio_update_t, alt_fun_0) + 1u));
+#endif
+
+/* Spread the 2-bit lanes of 8 pins into 4-bit lanes: the field of pin n moves to bit 4n */
+static inline u32_t _gpio_lane_2_to_4(u16_t lanes)
 {
-    gpio_port_t port = BS_GPIO_PORT(port_pin);
-    gpio_pin_t pin = BS_GPIO_PIN(port_pin);
-    if (port < BS_GPIO_PORT_NUM) {
+    u32_t x = lanes;
+
+    x = (x | (x << 8u)) & 0x00FF00FFu;
+    x = (x | (x << 4u)) & 0x0F0F0F0Fu;
+    x = (x | (x << 2u)) & 0x33333333u;
+    return x;
+}
+
+/**
+ * Decode the 8 pins of one half of the port. All fields are first spread into 4-bit pin lanes and merged into three planes holding
+ * bits 0-3, 4-7 and 8-11 of gpio_ctrl_1_t.value for every pin, so each pin only takes three nibble extracts.
+ */
+static void _gpio_decode_half(const gpio_cfg_regs_t *pCfg, u32_t octrl, u8_t half, gpio_ctrl_1_t *pSettings)
+{
+    u8_t shift = half * 8u;
+    u32_t in_out = _gpio_lane_2_to_4((u16_t)(pCfg->ctrl >> (shift * 2u)));
+    u32_t speed = _gpio_lane_2_to_4((u16_t)(pCfg->out_speed >> (shift * 2u)));
+    u32_t pd = _gpio_lane_2_to_4((u16_t)(pCfg->up_down >> (shift * 2u)));
+    u32_t omode = gpio_lane_4((u8_t)(pCfg->out_mode >> shift));
+    u32_t out = gpio_lane_4((u8_t)(octrl >> shift));
+
+    u32_t plane_0 = in_out | (omode << GPIO_CTRL_1_POS_OUT_MODE) | ((speed & 0x11111111u) << GPIO_CTRL_1_POS_SPEED);
+    u32_t plane_1 = ((speed >> 1u) & 0x11111111u) | (pd << (GPIO_CTRL_1_POS_UP_DOWN - 4u)) | (out << (GPIO_CTRL_1_POS_OUT_SET - 4u));
+    u32_t plane_2 = half ? pCfg->alt_fun_1 : pCfg->alt_fun_0;
+
+    for (u8_t i = 0u; i < 8u; i++) {
+        pSettings[i].value = (plane_0 & 0xFu) | ((plane_1 & 0xFu) << 4u) | ((plane_2 & 0xFu) << GPIO_CTRL_1_POS_ALTERNATE);
+        plane_0 >>= 4u;
+        plane_1 >>= 4u;
+        plane_2 >>= 4u;
+    }
+}
+
+/* Read the port registers once and decode the settings of all 16 pins into pSettings */
+u32_t gpio_port_decode(gpio_port_t port, gpio_ctrl_1_t *pSettings)
+{
+    if (port >= BS_GPIO_PORT_NUM) {
         return RESULT_INVALID_PORT;
     }
-    if (pin < BS_GPIO_PIN_NUM) {
-        return RESULT_INVALID_PIN;
+    if (!pSettings) {
+        return RESULT_INVALID_ARGS;
     }
 
     gpio_regs_t *pGpioRegs = (gpio_regs_t *)gpio_base_regs_addr(port);
-    u32_t ctrl = pGpioRegs->ctrl;
-    u32_t pd = pGpioRegs->up_down;
-    u32_t omode = pGpioRegs->out_mode;
-    u32_t speed = pGpioRegs->out_speed;
-    u16_t octrl = pGpioRegs->out_ctrl;
-    u32_t alt_0 = pGpioRegs->alt_fun_0;
-    u32_t alt_1 = pGpioRegs->alt_fun_1;
-
-    u32_t val = BS_MAP(CB(setting, in_out),
-                       CTRL_INPUT, 0u,
-                       CTRL_OUTPUT, 1u,
-                       CTRL_AFIO, 2u,
-                       CTRL_ANALOG, 3u);
-    BV_CS(ctrl, 2, pin, val);
-
-    val = BS_MAP(CB(setting, up_down),
-                 CTRL_FLOAT, 0u,
-                 CTRL_PULL_UP, 1u,
-                 CTRL_PULL_DOWN, 2u);
-    BV_CS(pd, 2, pin, val);
-
-    val = BS_MAP(CB(setting, out_mode),
-                 CTRL_PUSH_PULL, 0u,
-                 CTRL_OPEN_DRAIN, 1u);
-    BV_CS(omode, 1, pin, val);
-
-    val = BS_MAP(CB(setting, speed),
-                 CTRL_SPEED_LEVEL_0, 0u,
-                 CTRL_SPEED_LEVEL_1, 1u,
-                 CTRL_SPEED_LEVEL_2, 2u,
-                 CTRL_SPEED_LEVEL_3, 3u);
-    BV_CS(speed, 2, pin, val);
-
-    val = BS_MAP(CB(setting, out_set),
-                 CTRL_LOW, 0u,
-                 CTRL_HIGH, 1u);
-
-    if (val) {
-        BV_S(octrl, 1, pin, val);
-    } else {
-        BV_C(octrl, 1, pin);
+    gpio_cfg_regs_t cfg;
+    gpio_cfg_read(pGpioRegs, &cfg);
+    u32_t octrl = BS_REG_RD(pGpioRegs->out_ctrl);
+
+    _gpio_decode_half(&cfg, octrl, 0u, &pSettings[0]);
+    _gpio_decode_half(&cfg, octrl, 1u, &pSettings[8]);
+    return 0;
+}
+
+/* Read back the current setting of one pin, an AF pin reads its alternate function and every pin its out_ctrl level */
+u32_t gpio_ctrl_1_get(gpio_num_t port_pin, gpio_ctrl_1_t *pSetting)
+{
+    u32_t result = gpio_num_check(port_pin);
+    if (result) {
+        return result;
+    }
+    if (!pSetting) {
+        return RESULT_INVALID_ARGS;
     }
 
-    val = BS_MAP(CB(setting, alternate),
-                 CTRL_AF_FUNC_0, 0u,
-                 CTRL_AF_FUNC_1, 1u,
-                 CTRL_AF_FUNC_2, 2u,
-                 CTRL_AF_FUNC_3, 3u,
-                 CTRL_AF_FUNC_4, 4u,
-                 CTRL_AF_FUNC_5, 5u,
-                 CTRL_AF_FUNC_6, 6u,
-                 CTRL_AF_FUNC_7, 7u,
-                 CTRL_AF_FUNC_8, 8u,
-                 CTRL_AF_FUNC_9, 9u,
-                 CTRL_AF_FUNC_10, 10u,
-                 CTRL_AF_FUNC_11, 11u,
-                 CTRL_AF_FUNC_12, 12u,
-                 CTRL_AF_FUNC_13, 13u,
-                 CTRL_AF_FUNC_14, 14u,
-                 CTRL_AF_FUNC_15, 15);
-
-    if (pin < 8) {
-        BV_CS(alt_0, 4, pin, val);
-    } else {
-        BV_CS(alt_1, 4, pin - 8, val);
+    gpio_regs_t *pGpioRegs = (gpio_regs_t *)gpio_base_regs_addr(BS_GPIO_PORT(port_pin));
+    gpio_pin_t pin = BS_GPIO_PIN(port_pin);
+    gpio_cfg_regs_t cfg;
+    gpio_ctrl_1_t half[8];
+
+    gpio_cfg_read(pGpioRegs, &cfg);
+    _gpio_decode_half(&cfg, BS_REG_RD(pGpioRegs->out_ctrl), (u8_t)(pin >> 3u), half);
+    *pSetting = half[pin & 7u];
+    return 0;
+}
+
+/* Turn every pin outside pUsed[port] into an analog pin without pulls, gpio_restore then applies the parked image */
+u32_t gpio_snapshot_park(gpio_snapshot_t *pSnap, const u16_t *pUsed)
+{
+    if ((!pSnap) || (!pUsed)) {
+        return RESULT_INVALID_ARGS;
     }
 
-    pGpioRegs->ctrl = ctrl;
-    pGpioRegs->up_down = pd;
-    pGpioRegs->out_mode = omode;
-    pGpioRegs->out_speed = speed;
-    pGpioRegs->alt_fun_0 = alt_0;
-    pGpioRegs->alt_fun_1 = alt_1;
+    for (gpio_port_t port = 0u; port < BS_GPIO_PORT_NUM; port++) {
+        gpio_cfg_regs_t *pCfg = &pSnap->cfg[port];
+        u32_t lane_2 = gpio_lane_2((u16_t)~pUsed[port]);
+
+        pCfg->ctrl |= lane_2 * CTRL_ANALOG;
+        pCfg->up_down &= ~(lane_2 * MASK_BIT(2));
+    }
+
+    return 0;
+}
+
+/* The boot-time partition: pSecure[port] holds the secure pins of every port, each port costs one store and no read */
+u32_t gpio_secure_apply(const u16_t *pSecure)
+{
+    if (!pSecure) {
+        return RESULT_INVALID_ARGS;
+    }
+
+    for (gpio_port_t port = 0u; port < BS_GPIO_PORT_NUM; port++) {
+        gpio_regs_t *pGpioRegs = (gpio_regs_t *)gpio_base_regs_addr(port);
+        BS_REG_WR(pGpioRegs->secure, pSecure[port]);
+    }
 
     return 0;
 }
@@ -0,0 +1,263 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "bsi_host.h"
+
+#if defined(BS_HOST_ENABLED)
+
+/* The RAM-resident registers standing in for the GPIO ports */
+static gpio_regs_t g_host_gpio_regs[BS_GPIO_PORT_NUM];
+
+/* The level driven onto each port from outside */
+static u16_t g_host_gpio_input[BS_GPIO_PORT_NUM];
+
+/* Serialize the hardware model of each port, so concurrent callers never derive in_status from a stale out_ctrl */
+static u8_t g_host_gpio_lock[BS_GPIO_PORT_NUM];
+
+/* The register accesses issued by the BSI layer through BS_REG_RD and BS_REG_WR, counted per thread */
+__thread u32_t g_bs_host_reg_loads = 0u;
+__thread u32_t g_bs_host_reg_stores = 0u;
+
+/* The EXTI registers and the pending lines behind the write-1-to-clear pd register */
+static exti_regs_t g_host_exti_regs;
+static u32_t g_host_exti_pending = 0u;
+static u32_t g_host_timestamp = 0u;
+
+/* The EXTI source selection, SYSCFG or AFIO depending on the family */
+static exti_sel_regs_t g_host_exti_sel_regs;
+
+const uptr_t g_exti_base_regs = (uptr_t)&g_host_exti_regs;
+const uptr_t g_exti_sel_regs = (uptr_t)&g_host_exti_sel_regs;
+
+const uptr_t g_gpio_base_regs[BS_GPIO_PORT_NUM] = {
+    (uptr_t)&g_host_gpio_regs[BS_GPIO_PORT_A],
+    (uptr_t)&g_host_gpio_regs[BS_GPIO_PORT_B],
+    (uptr_t)&g_host_gpio_regs[BS_GPIO_PORT_C],
+};
+
+#if (BS_FAMILY == BS_FAMILY_GD32W51X)
+/* Collect the pins whose 2-bit ctrl field equals the mode into a 16-bit mask */
+static u16_t _host_ctrl_pins(u32_t ctrl, u32_t mode)
+{
+    u16_t pins = 0u;
+
+    for (u8_t pin = 0u; pin < BS_GPIO_PIN_NUM; pin++) {
+        if (((ctrl >> (pin * 2u)) & MASK_BIT(2)) == mode) {
+            pins |= (u16_t)SET_BIT(pin);
+        }
+    }
+    return pins;
+}
+
+static void _host_gpio_modes(const gpio_regs_t *pGpioRegs, u16_t *pOutputs, u16_t *pAnalogs)
+{
+    u32_t ctrl = __atomic_load_n(&pGpioRegs->ctrl, __ATOMIC_RELAXED);
+
+    *pOutputs = _host_ctrl_pins(ctrl, CTRL_OUTPUT);
+    *pAnalogs = _host_ctrl_pins(ctrl, CTRL_ANALOG);
+}
+#else
+/* A non-zero MD field marks an output nibble, the all-zero nibble an analog pin */
+static void _host_gpio_modes(const gpio_regs_t *pGpioRegs, u16_t *pOutputs, u16_t *pAnalogs)
+{
+    u16_t outputs = 0u;
+    u16_t analogs = 0u;
+
+    for (u8_t pin = 0u; pin < BS_GPIO_PIN_NUM; pin++) {
+        u32_t ctl = __atomic_load_n((pin < 8u) ? &pGpioRegs->ctl_0 : &pGpioRegs->ctl_1, __ATOMIC_RELAXED) >> ((pin & 7u) * 4u);
+        if (ctl & MASK_BIT(2)) {
+            outputs |= (u16_t)SET_BIT(pin);
+        } else if (!(ctl & MASK_BIT(4))) {
+            analogs |= (u16_t)SET_BIT(pin);
+        }
+    }
+    *pOutputs = outputs;
+    *pAnalogs = analogs;
+}
+#endif
+
+/* Apply a store into the write-only set, clear or toggle register to out_ctrl in one atomic step, the set half of bit_op wins */
+static void _host_gpio_action(gpio_regs_t *pGpioRegs, u32_t bop, u32_t clear, u32_t toggle)
+{
+    u32_t out = __atomic_load_n(&pGpioRegs->out_ctrl, __ATOMIC_RELAXED);
+    u32_t next;
+
+    do {
+        next = (((((out & ~(bop >> 16u)) | (bop & U16_V)) & ~clear) ^ toggle) & U16_V);
+    } while (!__atomic_compare_exchange_n(&pGpioRegs->out_ctrl, &out, next, TRUE, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED));
+}
+
+/* Take what a test stored into a write-only register directly, the BSI stores never leave anything there */
+static inline u32_t _host_gpio_take(vu32_t *pReg)
+{
+    return __atomic_load_n(pReg, __ATOMIC_RELAXED) ? __atomic_exchange_n(pReg, 0u, __ATOMIC_SEQ_CST) : 0u;
+}
+
+/**
+ * @brief The bus store of the BSI layer.
+ *
+ * A store into bit_op, clear or toggle of a port acts on out_ctrl at once and the register keeps reading zero, so two threads driving
+ * different pins of one port never overwrite each other's request before bs_host_gpio_sync runs.
+ */
+u32_t bs_host_reg_store(vu32_t *pReg, u32_t value)
+{
+    uptr_t offset = (uptr_t)pReg - (uptr_t)&g_host_gpio_regs[0];
+
+    if (offset < sizeof(g_host_gpio_regs)) {
+        gpio_regs_t *pGpioRegs = &g_host_gpio_regs[offset / sizeof(gpio_regs_t)];
+
+        if (pReg == &pGpioRegs->bit_op) {
+            _host_gpio_action(pGpioRegs, value, 0u, 0u);
+            return value;
+        }
+        if (pReg == &pGpioRegs->clear) {
+            _host_gpio_action(pGpioRegs, 0u, value, 0u);
+            return value;
+        }
+#if BS_GPIO_HAS_TOGGLE
+        if (pReg == &pGpioRegs->toggle) {
+            _host_gpio_action(pGpioRegs, 0u, 0u, value);
+            return value;
+        }
+#endif
+    }
+
+    __atomic_store_n(pReg, value, __ATOMIC_RELAXED);
+    return value;
+}
+
+/**
+ * @brief Model the hardware side effects after the BSI layer stored into the port.
+ *
+ * Values a test stored into the write-only bit_op, clear and, where present, toggle registers directly are folded into out_ctrl and
+ * read back as zero. The output pins reflect out_ctrl into in_status, the analog pins read low, and every other pin reads the level
+ * injected by bs_host_gpio_input. The port lock orders concurrent callers: each one runs after its own stores, so the last in_status
+ * written is derived from the latest out_ctrl.
+ */
+void bs_host_gpio_sync(u8_t inst)
+{
+    if (inst >= BS_GPIO_PORT_NUM) {
+        return;
+    }
+
+    gpio_regs_t *pGpioRegs = &g_host_gpio_regs[inst];
+    while (__atomic_test_and_set(&g_host_gpio_lock[inst], __ATOMIC_ACQUIRE)) {
+    }
+
+    u32_t bop = _host_gpio_take(&pGpioRegs->bit_op);
+    u32_t clear = _host_gpio_take(&pGpioRegs->clear);
+#if BS_GPIO_HAS_TOGGLE
+    u32_t toggle = _host_gpio_take(&pGpioRegs->toggle);
+#else
+    u32_t toggle = 0u;
+#endif
+    if (bop | clear | toggle) {
+        _host_gpio_action(pGpioRegs, bop, clear, toggle);
+    }
+
+    u16_t outputs, analogs;
+    _host_gpio_modes(pGpioRegs, &outputs, &analogs);
+    u32_t out = __atomic_load_n(&pGpioRegs->out_ctrl, __ATOMIC_RELAXED);
+    __atomic_store_n(&pGpioRegs->in_status, (out & outputs) | (g_host_gpio_input[inst] & (u16_t)~(outputs | analogs)), __ATOMIC_RELAXED);
+
+    __atomic_clear(&g_host_gpio_lock[inst], __ATOMIC_RELEASE);
+}
+
+gpio_regs_t *bs_host_gpio_regs(gpio_port_t port)
+{
+    if (port >= BS_GPIO_PORT_NUM) {
+        return NULL;
+    }
+    return &g_host_gpio_regs[port];
+}
+
+void bs_host_gpio_input(gpio_port_t port, u16_t mask, u16_t level)
+{
+    if (port >= BS_GPIO_PORT_NUM) {
+        return;
+    }
+
+    g_host_gpio_input[port] = (g_host_gpio_input[port] & (u16_t)~mask) | (level & mask);
+    bs_host_gpio_sync(port);
+}
+
+void bs_host_gpio_reset(void)
+{
+    memset((void *)g_host_gpio_regs, 0, sizeof(g_host_gpio_regs));
+    memset(g_host_gpio_input, 0, sizeof(g_host_gpio_input));
+    memset(g_host_gpio_lock, 0, sizeof(g_host_gpio_lock));
+    memset((void *)&g_host_exti_regs, 0, sizeof(g_host_exti_regs));
+    memset((void *)&g_host_exti_sel_regs, 0, sizeof(g_host_exti_sel_regs));
+    g_host_exti_pending = 0u;
+    g_host_timestamp = 0u;
+    g_bs_host_reg_loads = 0u;
+    g_bs_host_reg_stores = 0u;
+}
+
+/* Report the register accesses since the previous call and restart the counting */
+void bs_host_reg_count(u32_t *pLoads, u32_t *pStores)
+{
+    if (pLoads) {
+        *pLoads = g_bs_host_reg_loads;
+    }
+    if (pStores) {
+        *pStores = g_bs_host_reg_stores;
+    }
+    g_bs_host_reg_loads = 0u;
+    g_bs_host_reg_stores = 0u;
+}
+
+/* The store into pd clears the written lines, the register reads back the lines still pending */
+void bs_host_exti_sync(void)
+{
+    g_host_exti_pending &= ~g_host_exti_regs.pd;
+    g_host_exti_regs.pd = g_host_exti_pending;
+}
+
+exti_regs_t *bs_host_exti_regs(void)
+{
+    return &g_host_exti_regs;
+}
+
+exti_sel_regs_t *bs_host_exti_sel_regs(void)
+{
+    return &g_host_exti_sel_regs;
+}
+
+/* Latch the edges detected on the lines as the hardware does, the caller then runs exti_dispatch as the ISR */
+void bs_host_exti_raise(u16_t lines)
+{
+    g_host_exti_pending |= lines;
+    g_host_exti_regs.pd = g_host_exti_pending;
+}
+
+/**
+ * @brief Replay a trace, recorded here or dumped from a target of the same family, against the RAM-resident registers.
+ *
+ * The stores are applied in order and each one is followed by the hardware model, as on the target. The replay stops at the first
+ * entry outside the ports and returns the number of entries applied.
+ */
+u32_t bs_host_trace_replay(const gpio_trace_entry_t *pEntries, u32_t num)
+{
+    for (u32_t i = 0u; i < num; i++) {
+        const gpio_trace_entry_t *pEntry = &pEntries[i];
+        if ((pEntry->port >= BS_GPIO_PORT_NUM) || (pEntry->offset >= sizeof(gpio_regs_t)) || (pEntry->offset & 3u)) {
+            return i;
+        }
+
+        bs_host_reg_store((vu32_t *)((u8_t *)&g_host_gpio_regs[pEntry->port] + pEntry->offset), pEntry->value);
+        bs_host_gpio_sync(pEntry->port);
+    }
+    return num;
+}
+
+/* A counter standing in for the cycle counter, every read advances it */
+u32_t bs_host_timestamp(void)
+{
+    return __atomic_add_fetch(&g_host_timestamp, 1u, __ATOMIC_RELAXED);
+}
+
+#endif
@@ -0,0 +1,42 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#ifndef _BSI_TEST_H_
+#define _BSI_TEST_H_
+
+#include "bsi_host.h"
+
+/* Stop the test at the first failed check, the checks stay active in release builds unlike assert */
+#define BS_TEST_CHECK(cond)                                                                                                                \
+    do {                                                                                                                                   \
+        if (!(cond)) {                                                                                                                     \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);                                                               \
+            exit(1);                                                                                                                       \
+        }                                                                                                                                  \
+    } while (0)
+
+/* A xorshift generator, the tests seed it with a constant so every failure reproduces */
+static inline u32_t bs_test_random(u32_t *pState)
+{
+    u32_t x = *pState;
+
+    x ^= x << 13u;
+    x ^= x >> 17u;
+    x ^= x << 5u;
+    *pState = x;
+    return x;
+}
+
+/* A random setting word of the ctrl_1_b_t fields, including the encodings the encoder rejects */
+static inline gpio_ctrl_1_t bs_test_setting(u32_t *pState)
+{
+    gpio_ctrl_1_t setting;
+
+    setting.value = bs_test_random(pState) & MASK_BIT(12);
+    return setting;
+}
+
+#endif
@@ -0,0 +1,114 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "bsi_test.h"
+
+#define TEST_PA3 BS_GPIO_NUM(BS_GPIO_PORT_A, BS_GPIO_PIN_3)
+#define TEST_PB3 BS_GPIO_NUM(BS_GPIO_PORT_B, BS_GPIO_PIN_3)
+#define TEST_PC6 BS_GPIO_NUM(BS_GPIO_PORT_C, BS_GPIO_PIN_6)
+#define TEST_PA7 BS_GPIO_NUM(BS_GPIO_PORT_A, BS_GPIO_PIN_7)
+
+/* The calls the handlers received, in order */
+static exti_event_t g_test_calls[64];
+static u32_t g_test_call_num = 0u;
+
+static void _test_handler(gpio_num_t port_pin, u8_t edge, u32_t timestamp, void *pArg)
+{
+    BS_TEST_CHECK((pArg == (void *)&g_test_call_num) && (g_test_call_num < DIMOF(g_test_calls)));
+    g_test_calls[g_test_call_num++] = (exti_event_t){.port_pin = port_pin, .edge = edge, .timestamp = timestamp};
+}
+
+static u32_t _test_sel(u8_t line)
+{
+    exti_sel_regs_t *pSelRegs = bs_host_exti_sel_regs();
+
+    return (pSelRegs->extiss[line / BS_EXTI_SEL_LINES] >> ((line % BS_EXTI_SEL_LINES) * BS_EXTI_SEL_WIDTH)) & MASK_BIT(BS_EXTI_SEL_WIDTH);
+}
+
+/* Registration routes the port onto the line, arms the edges and unmasks it, a line serves one port at a time */
+static void _test_register(void)
+{
+    exti_regs_t *pExtiRegs = bs_host_exti_regs();
+    void *pArg = (void *)&g_test_call_num;
+
+    bs_host_exti_sel_regs()->extiss[1] = 0xFFFFu;
+    BS_TEST_CHECK(exti_register(TEST_PA3, EXTI_EDGE_RISING, _test_handler, pArg, FALSE) == 0u);
+    BS_TEST_CHECK(exti_register(TEST_PC6, EXTI_EDGE_BOTH, _test_handler, pArg, TRUE) == 0u);
+    BS_TEST_CHECK((_test_sel(3u) == BS_GPIO_PORT_A) && (_test_sel(6u) == BS_GPIO_PORT_C));
+    BS_TEST_CHECK((bs_host_exti_sel_regs()->extiss[1] & 0xF0FFu) == 0xF0FFu);
+    BS_TEST_CHECK((pExtiRegs->inten == 0x48u) && (pExtiRegs->rten == 0x48u) && (pExtiRegs->ften == 0x40u));
+
+    BS_TEST_CHECK(exti_register(TEST_PB3, EXTI_EDGE_FALLING, _test_handler, pArg, FALSE) == RESULT_INVALID_PIN);
+    BS_TEST_CHECK(_test_sel(3u) == BS_GPIO_PORT_A);
+    BS_TEST_CHECK(exti_register(TEST_PB3, 0u, _test_handler, pArg, FALSE) == RESULT_INVALID_ARGS);
+    BS_TEST_CHECK(exti_register(TEST_PB3, EXTI_EDGE_RISING, NULL, pArg, FALSE) == RESULT_INVALID_ARGS);
+}
+
+/* The direct line calls its handler from the dispatcher, the deferred one goes through the queue with the edge read from the pin */
+static void _test_dispatch(void)
+{
+    exti_regs_t *pExtiRegs = bs_host_exti_regs();
+    exti_event_t event;
+
+    bs_host_gpio_input(BS_GPIO_PORT_C, SET_BIT(BS_GPIO_PIN_6), SET_BIT(BS_GPIO_PIN_6));
+    bs_host_exti_raise(0x48u);
+    exti_dispatch(0x0008u);
+    BS_TEST_CHECK((g_test_call_num == 1u) && (g_test_calls[0].port_pin == TEST_PA3) && (g_test_calls[0].edge == EXTI_EDGE_RISING));
+    BS_TEST_CHECK(pExtiRegs->pd == 0x40u);
+
+    exti_dispatch(U16_V);
+    BS_TEST_CHECK((g_test_call_num == 1u) && (pExtiRegs->pd == 0u));
+    BS_TEST_CHECK(exti_event_pop(&event) && (event.port_pin == TEST_PC6) && (event.edge == EXTI_EDGE_RISING));
+    BS_TEST_CHECK(event.timestamp > g_test_calls[0].timestamp);
+    BS_TEST_CHECK(!exti_event_pop(&event));
+
+    /* A full queue drops the newest events, the drain hands the kept ones to the handler oldest first */
+    bs_host_gpio_input(BS_GPIO_PORT_C, SET_BIT(BS_GPIO_PIN_6), 0u);
+    for (u32_t i = 0u; i < (BS_EXTI_QUEUE_SIZE + 4u); i++) {
+        bs_host_exti_raise(0x40u);
+        exti_dispatch(U16_V);
+    }
+    g_test_call_num = 0u;
+    BS_TEST_CHECK(exti_drain(4u) == 4u);
+    BS_TEST_CHECK(exti_drain(0u) == (BS_EXTI_QUEUE_SIZE - 4u));
+    BS_TEST_CHECK(g_test_call_num == BS_EXTI_QUEUE_SIZE);
+    for (u32_t i = 0u; i < g_test_call_num; i++) {
+        BS_TEST_CHECK((g_test_calls[i].port_pin == TEST_PC6) && (g_test_calls[i].edge == EXTI_EDGE_FALLING));
+        BS_TEST_CHECK((!i) || (g_test_calls[i].timestamp > g_test_calls[i - 1u].timestamp));
+    }
+    BS_TEST_CHECK(exti_drain(0u) == 0u);
+}
+
+/* Only the port registered on a line releases it, a line never registered is refused even for port A */
+static void _test_unregister(void)
+{
+    exti_regs_t *pExtiRegs = bs_host_exti_regs();
+
+    BS_TEST_CHECK(exti_unregister(TEST_PA7) == RESULT_INVALID_PIN);
+    BS_TEST_CHECK(exti_unregister(TEST_PB3) == RESULT_INVALID_PIN);
+    BS_TEST_CHECK(exti_unregister(TEST_PA3) == 0u);
+    BS_TEST_CHECK(exti_unregister(TEST_PA3) == RESULT_INVALID_PIN);
+    BS_TEST_CHECK((pExtiRegs->inten == 0x40u) && (pExtiRegs->rten == 0x40u) && (pExtiRegs->ften == 0x40u));
+
+    g_test_call_num = 0u;
+    bs_host_exti_raise(0x08u);
+    exti_dispatch(U16_V);
+    BS_TEST_CHECK((g_test_call_num == 0u) && (pExtiRegs->pd == 0u));
+
+    BS_TEST_CHECK(exti_register(TEST_PB3, EXTI_EDGE_FALLING, _test_handler, (void *)&g_test_call_num, FALSE) == 0u);
+    BS_TEST_CHECK(_test_sel(3u) == BS_GPIO_PORT_B);
+}
+
+int main(void)
+{
+    bs_host_gpio_reset();
+    _test_register();
+    _test_dispatch();
+    _test_unregister();
+
+    printf("test_exti: ok\n");
+    return 0;
+}
@@ -0,0 +1,139 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "bsi_test.h"
+#include "bsi_gpio_capture.h"
+
+#define TEST_MASK      (0x0F3Cu)
+#define TEST_RING_MAX  (1024u)
+#define TEST_MODEL_MAX (4096u)
+
+static gpio_capture_entry_t g_test_ring[TEST_RING_MAX];
+
+/* The expected entries of an unbounded ring, the capture keeps the last size of them */
+static gpio_capture_entry_t g_test_model[TEST_MODEL_MAX];
+static u32_t g_test_model_num = 0u;
+static u32_t g_test_sample = 0u;
+
+static void _test_model_init(void)
+{
+    g_test_model_num = 0u;
+    g_test_sample = 0u;
+}
+
+/* Every decimation-th sample is kept, counting from the first one after init */
+static void _test_model_feed(u16_t level, u32_t samples, u16_t decimation, b_t rle)
+{
+    while (samples--) {
+        if ((++g_test_sample % decimation) != 0u) {
+            continue;
+        }
+        if (rle && g_test_model_num) {
+            gpio_capture_entry_t *pLast = &g_test_model[g_test_model_num - 1u];
+            if ((pLast->level == level) && (pLast->count != U16_V)) {
+                pLast->count++;
+                continue;
+            }
+        }
+        BS_TEST_CHECK(g_test_model_num < TEST_MODEL_MAX);
+        g_test_model[g_test_model_num].level = level;
+        g_test_model[g_test_model_num].count = 1u;
+        g_test_model_num++;
+    }
+}
+
+static void _test_feed(gpio_capture_t *pCap, u16_t level, u32_t samples)
+{
+    bs_host_gpio_input(BS_GPIO_PORT_A, U16_V, level);
+    gpio_capture_run(pCap, samples);
+    _test_model_feed(level & TEST_MASK, samples, pCap->decimation, pCap->rle);
+}
+
+/* The decoder walks the retained entries exactly: one edge per level change with the sample time it happened at */
+static void _test_decode(const gpio_capture_t *pCap)
+{
+    u32_t first = (g_test_model_num > pCap->size) ? (g_test_model_num - pCap->size) : 0u;
+    gpio_capture_iter_t iter;
+    gpio_capture_edge_t edge;
+    u32_t time = 0u;
+    u16_t level = 0u;
+
+    BS_TEST_CHECK(pCap->used == (g_test_model_num - first));
+    gpio_capture_iter_init(&iter, pCap);
+
+    for (u32_t i = first; i < g_test_model_num; i++) {
+        const gpio_capture_entry_t *pEntry = &g_test_model[i];
+        if ((i == first) || (pEntry->level != level)) {
+            BS_TEST_CHECK(gpio_capture_iter_next(&iter, &edge));
+            BS_TEST_CHECK(edge.time == time);
+            BS_TEST_CHECK(edge.level == pEntry->level);
+            BS_TEST_CHECK(edge.changed == ((i == first) ? 0u : (u16_t)(pEntry->level ^ level)));
+        }
+        time += pEntry->count;
+        level = pEntry->level;
+    }
+    BS_TEST_CHECK(!gpio_capture_iter_next(&iter, &edge));
+}
+
+/* Random runs of random levels, long enough that run-length entries form and short enough that the ring wraps */
+static void _test_random(u32_t size, u16_t decimation, b_t rle, u32_t runs)
+{
+    gpio_capture_t cap;
+    u32_t state = 0x1D872B41u ^ (size << 8u) ^ decimation;
+
+    bs_host_gpio_reset();
+    _test_model_init();
+    BS_TEST_CHECK(gpio_capture_init(&cap, BS_GPIO_PORT_A, TEST_MASK, g_test_ring, size, decimation, rle) == 0u);
+
+    while (runs--) {
+        u32_t random = bs_test_random(&state);
+        u16_t level = (random & 0x1u) ? (u16_t)(random >> 16u) : (u16_t)~(random >> 16u);
+        _test_feed(&cap, level, 1u + ((random >> 1u) % 24u));
+    }
+    _test_decode(&cap);
+}
+
+/* A held level splits into a saturated entry and a new one, and the decoder reports no edge between the two */
+static void _test_saturation(void)
+{
+    gpio_capture_t cap;
+    gpio_capture_iter_t iter;
+    gpio_capture_edge_t edge;
+
+    bs_host_gpio_reset();
+    _test_model_init();
+    BS_TEST_CHECK(gpio_capture_init(&cap, BS_GPIO_PORT_A, TEST_MASK, g_test_ring, 4u, 1u, TRUE) == 0u);
+    _test_feed(&cap, 0x0104u, U16_V + 10u);
+    _test_feed(&cap, 0x0800u, 3u);
+
+    BS_TEST_CHECK(cap.used == 3u);
+    BS_TEST_CHECK((g_test_ring[0].level == 0x0104u) && (g_test_ring[0].count == U16_V));
+    BS_TEST_CHECK((g_test_ring[1].level == 0x0104u) && (g_test_ring[1].count == 10u));
+    BS_TEST_CHECK((g_test_ring[2].level == 0x0800u) && (g_test_ring[2].count == 3u));
+
+    gpio_capture_iter_init(&iter, &cap);
+    BS_TEST_CHECK(gpio_capture_iter_next(&iter, &edge));
+    BS_TEST_CHECK((edge.time == 0u) && (edge.level == 0x0104u) && (edge.changed == 0u));
+    BS_TEST_CHECK(gpio_capture_iter_next(&iter, &edge));
+    BS_TEST_CHECK((edge.time == (U16_V + 10u)) && (edge.level == 0x0800u) && (edge.changed == 0x0904u));
+    BS_TEST_CHECK(!gpio_capture_iter_next(&iter, &edge));
+
+    _test_decode(&cap);
+}
+
+int main(void)
+{
+    _test_saturation();
+    _test_random(TEST_RING_MAX, 1u, TRUE, 64u);
+    _test_random(TEST_RING_MAX, 1u, FALSE, 32u);
+    _test_random(8u, 1u, TRUE, 200u);
+    _test_random(16u, 1u, FALSE, 200u);
+    _test_random(8u, 3u, TRUE, 200u);
+    _test_random(32u, 4u, FALSE, 200u);
+
+    printf("test_gpio_capture: ok\n");
+    return 0;
+}
@@ -0,0 +1,140 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "bsi_test.h"
+
+#define TEST_TRIALS (20000u)
+
+/* Fill the port with a random configuration behind the BSI layer, the shadow is told so */
+static void _test_random_port(gpio_port_t port, u32_t *pState)
+{
+    gpio_regs_t *pGpioRegs = bs_host_gpio_regs(port);
+
+#define TEST_RANDOM_REG(reg, width, first) pGpioRegs->reg = bs_test_random(pState);
+    GPIO_CFG_REGS(TEST_RANDOM_REG)
+#undef TEST_RANDOM_REG
+    pGpioRegs->out_ctrl = bs_test_random(pState) & U16_V;
+    bs_host_gpio_sync(port);
+#if BS_GPIO_SHADOW_ENABLED
+    BS_TEST_CHECK(gpio_shadow_sync(port) == 0u);
+#endif
+}
+
+/* The registers after a commit are the encoded update merged into the registers before it, whatever commit path the build selects */
+static void _test_commit_merges(void)
+{
+    gpio_regs_t *pGpioRegs = bs_host_gpio_regs(BS_GPIO_PORT_B);
+    u32_t state = 0x6C078965u;
+
+    for (u32_t trial = 0u; trial < TEST_TRIALS; trial++) {
+        _test_random_port(BS_GPIO_PORT_B, &state);
+        gpio_ctrl_1_t setting = bs_test_setting(&state);
+        u16_t pin_mask = (u16_t)bs_test_random(&state) | 1u;
+        gpio_regs_t expect = *pGpioRegs;
+        gpio_update_t update;
+
+        u32_t result = gpio_ctrl_1_encode(pin_mask, setting, &update);
+        BS_TEST_CHECK(gpio_ctrl_1_set_mask(BS_GPIO_PORT_B, pin_mask, setting) == result);
+        if (!result) {
+#define TEST_MERGE_REG(reg, width, first) expect.reg = gpio_field_merge(expect.reg, &update.reg);
+            GPIO_CFG_REGS(TEST_MERGE_REG)
+#undef TEST_MERGE_REG
+            expect.out_ctrl = gpio_field_merge(expect.out_ctrl, &update.out_ctrl);
+        }
+
+#define TEST_CHECK_REG(reg, width, first) BS_TEST_CHECK(pGpioRegs->reg == expect.reg);
+        GPIO_CFG_REGS(TEST_CHECK_REG)
+#undef TEST_CHECK_REG
+        BS_TEST_CHECK(pGpioRegs->out_ctrl == expect.out_ctrl);
+    }
+}
+
+/* The diff mode reports one store per register whose content changes and none when the pin already holds the setting */
+static void _test_apply_diff(void)
+{
+    gpio_regs_t *pGpioRegs = bs_host_gpio_regs(BS_GPIO_PORT_C);
+    u32_t state = 0x0BADF00Du;
+
+    for (u32_t trial = 0u; trial < TEST_TRIALS; trial++) {
+        _test_random_port(BS_GPIO_PORT_C, &state);
+        gpio_ctrl_1_t setting = bs_test_setting(&state);
+        gpio_num_t port_pin = BS_GPIO_NUM(BS_GPIO_PORT_C, bs_test_random(&state) & 15u);
+        gpio_regs_t before = *pGpioRegs;
+        u8_t writes = 0xFFu;
+
+        if (gpio_ctrl_1_apply(port_pin, setting, &writes)) {
+            BS_TEST_CHECK(writes == 0xFFu);
+            continue;
+        }
+
+        u8_t changed = (pGpioRegs->out_ctrl != before.out_ctrl) ? 1u : 0u;
+#define TEST_COUNT_REG(reg, width, first) changed += (pGpioRegs->reg != before.reg) ? 1u : 0u;
+        GPIO_CFG_REGS(TEST_COUNT_REG)
+#undef TEST_COUNT_REG
+        BS_TEST_CHECK(writes == changed);
+
+        bs_host_reg_count(NULL, NULL);
+        BS_TEST_CHECK((gpio_ctrl_1_apply(port_pin, setting, &writes) == 0u) && (writes == 0u));
+#if !BS_GPIO_ATOMIC_ENABLED
+        u32_t stores;
+        bs_host_reg_count(NULL, &stores);
+        BS_TEST_CHECK(stores == 0u);
+#endif
+    }
+}
+
+/* A snapshot restored over a scrambled port brings back every register, and the next commit builds on the restored content */
+static void _test_snapshot_restore(void)
+{
+    gpio_regs_t *pGpioRegs = bs_host_gpio_regs(BS_GPIO_PORT_A);
+    gpio_snapshot_t snap;
+    u32_t state = 0x31415926u;
+
+    _test_random_port(BS_GPIO_PORT_A, &state);
+    gpio_regs_t saved = *pGpioRegs;
+    BS_TEST_CHECK(gpio_snapshot(&snap) == 0u);
+    _test_random_port(BS_GPIO_PORT_A, &state);
+    BS_TEST_CHECK(gpio_restore(&snap) == 0u);
+
+#define TEST_CHECK_REG(reg, width, first) BS_TEST_CHECK(pGpioRegs->reg == saved.reg);
+    GPIO_CFG_REGS(TEST_CHECK_REG)
+#undef TEST_CHECK_REG
+    BS_TEST_CHECK(pGpioRegs->out_ctrl == saved.out_ctrl);
+
+    u8_t writes;
+    gpio_ctrl_1_t setting;
+    BS_TEST_CHECK(gpio_ctrl_1_get(BS_GPIO_NUM(BS_GPIO_PORT_A, 9u), &setting) == 0u);
+    BS_TEST_CHECK((gpio_ctrl_1_apply(BS_GPIO_NUM(BS_GPIO_PORT_A, 9u), setting, &writes) == 0u) && (writes == 0u));
+}
+
+/* The direction switch flips the pin between input and output and leaves the rest of its setting alone */
+static void _test_dir(void)
+{
+    gpio_ctrl_1_t out = GPIO_CTRL_1_VAL(CTRL_OUTPUT, CTRL_OPEN_DRAIN, CTRL_SPEED_LEVEL_1, CTRL_FLOAT, CTRL_LOW, CTRL_AF_FUNC_0);
+    gpio_num_t port_pin = BS_GPIO_NUM(BS_GPIO_PORT_A, 11u);
+    gpio_ctrl_1_t setting;
+    gpio_dir_t dir;
+
+    BS_TEST_CHECK(gpio_ctrl_1_set(port_pin, out) == 0u);
+    BS_TEST_CHECK(gpio_dir_init(&dir, port_pin) == 0u);
+
+    gpio_dir_in(&dir);
+    BS_TEST_CHECK((gpio_ctrl_1_get(port_pin, &setting) == 0u) && (setting.bits.in_out == CTRL_INPUT));
+    gpio_dir_out(&dir);
+    BS_TEST_CHECK((gpio_ctrl_1_get(port_pin, &setting) == 0u) && (setting.value == out.value));
+}
+
+int main(void)
+{
+    bs_host_gpio_reset();
+    _test_commit_merges();
+    _test_apply_diff();
+    _test_snapshot_restore();
+    _test_dir();
+
+    printf("test_gpio_commit: ok\n");
+    return 0;
+}
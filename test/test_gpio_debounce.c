@@ -0,0 +1,85 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "bsi_test.h"
+#include "bsi_gpio_debounce.h"
+
+#define TEST_SAMPLES (4096u)
+
+/* The per-pin debounce the vertical counters replace, one counter and one compare per pin and sample */
+typedef struct {
+    u8_t count[BS_GPIO_PIN_NUM];
+    u16_t stable;
+    u8_t depth;
+} test_debounce_pin_t;
+
+static u16_t g_test_samples[TEST_SAMPLES];
+
+static u16_t _test_debounce_pin(test_debounce_pin_t *pDeb, u16_t sample)
+{
+    for (u8_t pin = 0u; pin < BS_GPIO_PIN_NUM; pin++) {
+        if (!((sample ^ pDeb->stable) & SET_BIT(pin))) {
+            pDeb->count[pin] = 0u;
+        } else if (++pDeb->count[pin] >= pDeb->depth) {
+            pDeb->count[pin] = 0u;
+            pDeb->stable ^= (u16_t)SET_BIT(pin);
+        }
+    }
+    return pDeb->stable;
+}
+
+/* Every pin holds a level for a random while and bounces around each change, so both paths see flips and resets */
+static void _test_samples(void)
+{
+    u32_t state = 0xC0FFEEu;
+    u16_t level = 0u;
+
+    for (u32_t i = 0u; i < TEST_SAMPLES; i++) {
+        u32_t r = bs_test_random(&state);
+        if (!(r & 0x3Fu)) {
+            level ^= (u16_t)(r >> 16u);
+        }
+        g_test_samples[i] = level ^ ((r & 0xC0u) ? 0u : (u16_t)bs_test_random(&state));
+    }
+}
+
+/* The vertical counters agree with the per-pin loop on every sample at every depth, and the edges are the pins that just flipped */
+static void _test_debounce_matches_pins(void)
+{
+    for (u8_t depth = 1u; depth <= GPIO_DEBOUNCE_DEPTH_MAX; depth++) {
+        gpio_debounce_t deb;
+        test_debounce_pin_t pin = {.stable = 0x1234u, .depth = depth};
+
+        BS_TEST_CHECK(gpio_debounce_init(&deb, 0x1234u, depth) == 0u);
+        for (u32_t i = 0u; i < TEST_SAMPLES; i++) {
+            u16_t before = pin.stable;
+            u16_t stable = _test_debounce_pin(&pin, g_test_samples[i]);
+
+            BS_TEST_CHECK(gpio_debounce_update(&deb, g_test_samples[i]) == stable);
+            BS_TEST_CHECK(deb.rising == (u16_t)(~before & stable));
+            BS_TEST_CHECK(deb.falling == (u16_t)(before & ~stable));
+        }
+    }
+}
+
+static void _test_debounce_init(void)
+{
+    gpio_debounce_t deb;
+
+    BS_TEST_CHECK(gpio_debounce_init(NULL, 0u, 1u) == RESULT_INVALID_ARGS);
+    BS_TEST_CHECK(gpio_debounce_init(&deb, 0u, 0u) == RESULT_INVALID_ARGS);
+    BS_TEST_CHECK(gpio_debounce_init(&deb, 0u, GPIO_DEBOUNCE_DEPTH_MAX + 1u) == RESULT_INVALID_ARGS);
+}
+
+int main(void)
+{
+    _test_samples();
+    _test_debounce_matches_pins();
+    _test_debounce_init();
+
+    printf("test_gpio_debounce: ok\n");
+    return 0;
+}
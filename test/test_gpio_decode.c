@@ -0,0 +1,80 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "bsi_test.h"
+
+#define TEST_TRIALS (20000u)
+
+/* gpio_port_decode must return for every pin exactly what gpio_ctrl_1_get decodes for it alone */
+static void _test_decode_matches_pins(gpio_port_t port)
+{
+    gpio_ctrl_1_t settings[BS_GPIO_PIN_NUM];
+
+    BS_TEST_CHECK(gpio_port_decode(port, settings) == 0u);
+    for (gpio_pin_t pin = 0u; pin < BS_GPIO_PIN_NUM; pin++) {
+        gpio_ctrl_1_t setting;
+        BS_TEST_CHECK(gpio_ctrl_1_get(BS_GPIO_NUM(port, pin), &setting) == 0u);
+        BS_TEST_CHECK(settings[pin].value == setting.value);
+    }
+}
+
+/* Random settings written pin by pin, the encodings the encoder rejects leave the pin as it was */
+static void _test_decode_settings(void)
+{
+    u32_t state = 0x6A09E667u;
+
+    bs_host_gpio_reset();
+    for (u32_t trial = 0u; trial < TEST_TRIALS; trial++) {
+        gpio_port_t port = (gpio_port_t)(bs_test_random(&state) % BS_GPIO_PORT_NUM);
+        for (gpio_pin_t pin = 0u; pin < BS_GPIO_PIN_NUM; pin++) {
+            gpio_ctrl_1_set(BS_GPIO_NUM(port, pin), bs_test_setting(&state));
+        }
+        _test_decode_matches_pins(port);
+    }
+}
+
+/* Random register contents reach the encodings no setting writes, the two decoders still have to agree on them */
+static void _test_decode_registers(void)
+{
+    gpio_regs_t *pGpioRegs = bs_host_gpio_regs(BS_GPIO_PORT_C);
+    u32_t state = 0xBB67AE85u;
+
+    for (u32_t trial = 0u; trial < TEST_TRIALS; trial++) {
+#define TEST_RANDOM_REG(reg, width, first) pGpioRegs->reg = bs_test_random(&state);
+        GPIO_CFG_REGS(TEST_RANDOM_REG)
+#undef TEST_RANDOM_REG
+        pGpioRegs->out_ctrl = bs_test_random(&state) & U16_V;
+        _test_decode_matches_pins(BS_GPIO_PORT_C);
+    }
+}
+
+/* One load per register of the update, out_ctrl included, whatever the port holds and nothing for the rejected calls */
+static void _test_decode_accesses(void)
+{
+    gpio_ctrl_1_t settings[BS_GPIO_PIN_NUM];
+    u32_t regs = sizeof(gpio_update_t) / sizeof(gpio_field_t);
+    u32_t loads, stores;
+
+    bs_host_reg_count(NULL, NULL);
+    BS_TEST_CHECK(gpio_port_decode(BS_GPIO_PORT_A, settings) == 0u);
+    bs_host_reg_count(&loads, &stores);
+    BS_TEST_CHECK((loads == regs) && (stores == 0u));
+
+    BS_TEST_CHECK(gpio_port_decode(BS_GPIO_PORT_NUM, settings) == RESULT_INVALID_PORT);
+    BS_TEST_CHECK(gpio_port_decode(BS_GPIO_PORT_A, NULL) == RESULT_INVALID_ARGS);
+    bs_host_reg_count(&loads, &stores);
+    BS_TEST_CHECK((loads == 0u) && (stores == 0u));
+}
+
+int main(void)
+{
+    _test_decode_settings();
+    _test_decode_registers();
+    _test_decode_accesses();
+
+    printf("test_gpio_decode: ok\n");
+    return 0;
+}
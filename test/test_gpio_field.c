@@ -0,0 +1,52 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "bsi_test.h"
+
+#define TEST_TRIALS (200000u)
+
+/* The field engine of the size build must encode every setting and pin mask exactly as the hand-written encoder of the default build */
+static void _test_encode_matches(void)
+{
+    u32_t state = 0x6C078965u;
+
+    for (u32_t trial = 0u; trial < TEST_TRIALS; trial++) {
+        gpio_ctrl_1_t setting = bs_test_setting(&state);
+        u16_t pin_mask = (u16_t)bs_test_random(&state);
+        gpio_update_t engine, direct;
+
+        memset(&engine, 0, sizeof(engine));
+        memset(&direct, 0, sizeof(direct));
+        u32_t result = gpio_ctrl_1_encode(pin_mask, setting, &engine);
+        BS_TEST_CHECK(result == gpio_ctrl_1_encode_direct(pin_mask, setting, &direct));
+        BS_TEST_CHECK(result || !memcmp(&engine, &direct, sizeof(gpio_update_t)));
+    }
+}
+
+/* The engine commit keeps the register order of the default one: the level goes out through bit_op ahead of the mode switch in ctrl */
+static void _test_apply_order(void)
+{
+    gpio_ctrl_1_t out = GPIO_CTRL_1_VAL(CTRL_OUTPUT, CTRL_PUSH_PULL, CTRL_SPEED_LEVEL_2, CTRL_FLOAT, CTRL_HIGH, CTRL_AF_FUNC_0);
+    gpio_num_t port_pin = BS_GPIO_NUM(BS_GPIO_PORT_A, 3u);
+    gpio_regs_t *pGpioRegs = bs_host_gpio_regs(BS_GPIO_PORT_A);
+    u8_t writes;
+
+    bs_host_gpio_reset();
+    BS_TEST_CHECK((gpio_ctrl_1_apply(port_pin, out, &writes) == 0u) && (writes == 3u));
+    BS_TEST_CHECK((pGpioRegs->out_ctrl == SET_BIT(3u)) && (pGpioRegs->ctrl == (GPIO_CTRL_1(CTRL_OUTPUT) << 6u)));
+    BS_TEST_CHECK((pGpioRegs->out_speed == (CTRL_SPEED_LEVEL_2 << 6u)) && (pGpioRegs->in_status == SET_BIT(3u)));
+    BS_TEST_CHECK((gpio_ctrl_1_apply(port_pin, out, &writes) == 0u) && (writes == 0u));
+}
+
+int main(void)
+{
+    bs_host_gpio_reset();
+    _test_encode_matches();
+    _test_apply_order();
+
+    printf("test_gpio_field: ok\n");
+    return 0;
+}
@@ -0,0 +1,53 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "bsi_gpio.hpp"
+#include "bsi_test.h"
+
+using Led = bsi::Pin<BS_GPIO_PORT_B, BS_GPIO_PIN_12>;
+
+/* The settings are spelled bsi::CTRL_* and fold into the same registers gpio_ctrl_1_set programs for them */
+static void _test_configure()
+{
+    gpio_ctrl_1_t setting;
+
+    BS_TEST_CHECK((Led::configure<bsi::CTRL_AFIO, bsi::CTRL_OPEN_DRAIN, bsi::CTRL_SPEED_LEVEL_3, bsi::CTRL_PULL_UP, bsi::CTRL_HIGH,
+                                  bsi::CTRL_AF_FUNC_5>()) == 0u);
+    BS_TEST_CHECK(gpio_ctrl_1_get(Led::num, &setting) == 0u);
+    BS_TEST_CHECK((setting.bits.in_out == bsi::CTRL_AFIO) && (setting.bits.out_set == bsi::CTRL_HIGH));
+#if (BS_FAMILY == BS_FAMILY_GD32W51X)
+    BS_TEST_CHECK((setting.bits.out_mode == bsi::CTRL_OPEN_DRAIN) && (setting.bits.up_down == bsi::CTRL_PULL_UP));
+    BS_TEST_CHECK((setting.bits.speed == bsi::CTRL_SPEED_LEVEL_3) && (setting.bits.alternate == bsi::CTRL_AF_FUNC_5));
+#endif
+    BS_TEST_CHECK(bsi::CTRL_OUTPUT == ctrl_1_b_t::CTRL_OUTPUT);
+    BS_TEST_CHECK((bsi::CTRL_LOCK == ctrl_2_b_t::CTRL_LOCK) && (bsi::CTRL_POWER_OFF == ctrl_2_b_t::CTRL_POWER_OFF));
+}
+
+static void _test_output()
+{
+    using namespace bsi;
+
+    BS_TEST_CHECK((Led::configure<CTRL_OUTPUT, CTRL_PUSH_PULL, CTRL_SPEED_LEVEL_1, CTRL_FLOAT, CTRL_LOW, CTRL_AF_FUNC_0>()) == 0u);
+    BS_TEST_CHECK(!Led::read());
+    Led::set();
+    BS_TEST_CHECK(Led::read());
+    Led::toggle();
+    BS_TEST_CHECK(!Led::read());
+    Led::write(true);
+    BS_TEST_CHECK(Led::read());
+    Led::clear();
+    BS_TEST_CHECK(!Led::read());
+}
+
+int main()
+{
+    bs_host_gpio_reset();
+    _test_configure();
+    _test_output();
+
+    printf("test_gpio_hpp: ok\n");
+    return 0;
+}
@@ -0,0 +1,64 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "bsi_test.h"
+
+/* The lane edges with the widest settings, a value spilling into the neighbouring lane or register shows up as a difference */
+#define TEST_IMAGE_PINS(PIN)                                                                                                               \
+    PIN(BS_GPIO_PIN_0, CTRL_ANALOG, CTRL_OPEN_DRAIN, CTRL_SPEED_LEVEL_3, CTRL_PULL_DOWN, CTRL_HIGH, CTRL_AF_FUNC_15)                      \
+    PIN(BS_GPIO_PIN_7, CTRL_AFIO, CTRL_OPEN_DRAIN, CTRL_SPEED_LEVEL_3, CTRL_PULL_UP, CTRL_HIGH, CTRL_AF_FUNC_15)                         \
+    PIN(BS_GPIO_PIN_8, CTRL_OUTPUT, CTRL_PUSH_PULL, CTRL_SPEED_LEVEL_1, CTRL_FLOAT, CTRL_HIGH, CTRL_AF_FUNC_15)                          \
+    PIN(BS_GPIO_PIN_15, CTRL_INPUT, CTRL_OPEN_DRAIN, CTRL_SPEED_LEVEL_3, CTRL_PULL_DOWN, CTRL_LOW, CTRL_AF_FUNC_15)
+
+#define TEST_IMAGE_SETTING(pin, ...) {(pin), GPIO_CTRL_1_VAL(__VA_ARGS__)},
+
+static const gpio_image_t g_test_image = GPIO_IMAGE(BS_GPIO_PORT_A, TEST_IMAGE_PINS);
+static const gpio_image_t g_test_pin_image = {BS_GPIO_PORT_A, GPIO_IMAGE_PIN_UPDATE(BS_GPIO_PIN_15, CTRL_AFIO, CTRL_OPEN_DRAIN,
+                                                                                    CTRL_SPEED_LEVEL_3, CTRL_PULL_DOWN, CTRL_HIGH,
+                                                                                    CTRL_AF_FUNC_15)};
+
+typedef struct {
+    gpio_pin_t pin;
+    gpio_ctrl_1_t setting;
+} test_setting_t;
+
+static const test_setting_t g_test_settings[] = {TEST_IMAGE_PINS(TEST_IMAGE_SETTING)};
+static const test_setting_t g_test_pin_settings[] = {
+    {BS_GPIO_PIN_15, GPIO_CTRL_1_VAL(CTRL_AFIO, CTRL_OPEN_DRAIN, CTRL_SPEED_LEVEL_3, CTRL_PULL_DOWN, CTRL_HIGH, CTRL_AF_FUNC_15)},
+};
+
+/* Port A takes the image and port B the same settings through gpio_ctrl_1_set, both start from the same random registers */
+static void _test_image_matches_pins(const gpio_image_t *pImage, const test_setting_t *pSettings, u32_t num)
+{
+    gpio_regs_t *pA = bs_host_gpio_regs(BS_GPIO_PORT_A);
+    gpio_regs_t *pB = bs_host_gpio_regs(BS_GPIO_PORT_B);
+    u32_t state = 0x9E3779B9u;
+
+    for (u32_t trial = 0u; trial < 64u; trial++) {
+#define TEST_RANDOM_REG(reg, width, first) pA->reg = pB->reg = bs_test_random(&state);
+        GPIO_CFG_REGS(TEST_RANDOM_REG)
+#undef TEST_RANDOM_REG
+        pA->out_ctrl = pB->out_ctrl = bs_test_random(&state) & U16_V;
+        bs_host_gpio_sync(BS_GPIO_PORT_A);
+        bs_host_gpio_sync(BS_GPIO_PORT_B);
+
+        BS_TEST_CHECK(gpio_apply_images(pImage, 1u) == 0u);
+        for (u32_t i = 0u; i < num; i++) {
+            BS_TEST_CHECK(gpio_ctrl_1_set(BS_GPIO_NUM(BS_GPIO_PORT_B, pSettings[i].pin), pSettings[i].setting) == 0u);
+        }
+        BS_TEST_CHECK(!memcmp((const void *)pA, (const void *)pB, sizeof(gpio_regs_t)));
+    }
+}
+
+int main(void)
+{
+    bs_host_gpio_reset();
+    _test_image_matches_pins(&g_test_image, g_test_settings, DIMOF(g_test_settings));
+    _test_image_matches_pins(&g_test_pin_image, g_test_pin_settings, DIMOF(g_test_pin_settings));
+
+    printf("test_gpio_image: ok\n");
+    return 0;
+}
@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "bsi_test.h"
+
+#define TEST_TRIALS (20000u)
+
+/* Load the same random configuration into both ports, the stores of the BSI layer then land on identical registers */
+static void _test_random_ports(gpio_regs_t *pA, gpio_regs_t *pB, u32_t *pState)
+{
+#define TEST_RANDOM_REG(reg, width, first) pA->reg = pB->reg = bs_test_random(pState);
+    GPIO_CFG_REGS(TEST_RANDOM_REG)
+#undef TEST_RANDOM_REG
+    pA->out_ctrl = pB->out_ctrl = bs_test_random(pState) & U16_V;
+    bs_host_gpio_sync(BS_GPIO_PORT_A);
+    bs_host_gpio_sync(BS_GPIO_PORT_B);
+}
+
+/* gpio_ctrl_1_set_mask on port A must leave the registers exactly as gpio_ctrl_1_set called for every pin of the mask on port B */
+static void _test_mask_matches_pins(void)
+{
+    gpio_regs_t *pA = bs_host_gpio_regs(BS_GPIO_PORT_A);
+    gpio_regs_t *pB = bs_host_gpio_regs(BS_GPIO_PORT_B);
+    u32_t state = 0x2545F491u;
+
+    for (u32_t trial = 0u; trial < TEST_TRIALS; trial++) {
+        _test_random_ports(pA, pB, &state);
+        gpio_ctrl_1_t setting = bs_test_setting(&state);
+        u16_t pin_mask = (u16_t)bs_test_random(&state);
+        if (!pin_mask) {
+            BS_TEST_CHECK(gpio_ctrl_1_set_mask(BS_GPIO_PORT_A, pin_mask, setting) == RESULT_INVALID_PIN);
+            continue;
+        }
+
+        u32_t mask_result = gpio_ctrl_1_set_mask(BS_GPIO_PORT_A, pin_mask, setting);
+        u32_t pin_result = 0u;
+        for (gpio_pin_t pin = 0u; pin < BS_GPIO_PIN_NUM; pin++) {
+            if (pin_mask & SET_BIT(pin)) {
+                pin_result |= gpio_ctrl_1_set(BS_GPIO_NUM(BS_GPIO_PORT_B, pin), setting);
+            }
+        }
+
+        BS_TEST_CHECK(mask_result == pin_result);
+        BS_TEST_CHECK(!memcmp((const void *)pA, (const void *)pB, sizeof(gpio_regs_t)));
+    }
+}
+
+/* Every register is loaded and stored at most once per call, however many pins the mask holds */
+static void _test_mask_accesses(void)
+{
+    gpio_ctrl_1_t setting = GPIO_CTRL_1_VAL(CTRL_AFIO, CTRL_OPEN_DRAIN, CTRL_SPEED_LEVEL_2, CTRL_PULL_UP, CTRL_HIGH, CTRL_AF_FUNC_7);
+    u32_t regs = sizeof(gpio_update_t) / sizeof(gpio_field_t);
+    u32_t loads, stores;
+
+    bs_host_gpio_reset();
+    BS_TEST_CHECK(gpio_ctrl_1_set_mask(BS_GPIO_PORT_C, 0x5AA5u, setting) == 0u);
+    bs_host_reg_count(&loads, &stores);
+    BS_TEST_CHECK((loads <= regs) && (stores <= regs));
+
+    BS_TEST_CHECK(gpio_ctrl_1_set_mask(BS_GPIO_PORT_NUM, 0x0001u, setting) == RESULT_INVALID_PORT);
+    bs_host_reg_count(&loads, &stores);
+    BS_TEST_CHECK((loads == 0u) && (stores == 0u));
+}
+
+int main(void)
+{
+    bs_host_gpio_reset();
+    _test_mask_matches_pins();
+    _test_mask_accesses();
+
+    printf("test_gpio_mask: ok\n");
+    return 0;
+}
@@ -0,0 +1,139 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "bsi_test.h"
+#include "bsi_gpio_notify.h"
+
+#define TEST_LOG_SIZE (32u)
+
+typedef struct {
+    gpio_num_t port_pin;
+    b_t level;
+    void *pArg;
+} test_call_t;
+
+static test_call_t g_test_log[TEST_LOG_SIZE];
+static u32_t g_test_calls = 0u;
+
+static void _test_handler(gpio_num_t port_pin, b_t level, void *pArg)
+{
+    BS_TEST_CHECK(g_test_calls < TEST_LOG_SIZE);
+    g_test_log[g_test_calls].port_pin = port_pin;
+    g_test_log[g_test_calls].level = level;
+    g_test_log[g_test_calls].pArg = pArg;
+    g_test_calls++;
+}
+
+static void _test_expect(u32_t index, gpio_port_t port, gpio_pin_t pin, b_t level)
+{
+    BS_TEST_CHECK(index < g_test_calls);
+    BS_TEST_CHECK(g_test_log[index].port_pin == BS_GPIO_NUM(port, pin));
+    BS_TEST_CHECK(g_test_log[index].level == level);
+    BS_TEST_CHECK(g_test_log[index].pArg == (void *)&g_test_log[pin]);
+}
+
+static void _test_register(gpio_port_t port, gpio_pin_t pin, u8_t edges)
+{
+    BS_TEST_CHECK(gpio_notify_register(BS_GPIO_NUM(port, pin), edges, _test_handler, (void *)&g_test_log[pin]) == 0u);
+}
+
+/* The edge filters of each pin, and the handlers of the changed pins only called in ascending pin order */
+static void _test_edges(void)
+{
+    _test_register(BS_GPIO_PORT_A, 1u, GPIO_NOTIFY_RISING);
+    _test_register(BS_GPIO_PORT_A, 4u, GPIO_NOTIFY_FALLING);
+    _test_register(BS_GPIO_PORT_A, 9u, GPIO_NOTIFY_BOTH);
+    _test_register(BS_GPIO_PORT_A, 15u, GPIO_NOTIFY_BOTH);
+    BS_TEST_CHECK(gpio_notify_feed(BS_GPIO_PORT_A, 0x0000u) == 0u);
+
+    /* Everything rises: the falling-only pin stays quiet, unregistered pins never dispatch */
+    g_test_calls = 0u;
+    BS_TEST_CHECK(gpio_notify_feed(BS_GPIO_PORT_A, U16_V) == 0u);
+    BS_TEST_CHECK(g_test_calls == 3u);
+    _test_expect(0u, BS_GPIO_PORT_A, 1u, TRUE);
+    _test_expect(1u, BS_GPIO_PORT_A, 9u, TRUE);
+    _test_expect(2u, BS_GPIO_PORT_A, 15u, TRUE);
+
+    /* The same sample again changes nothing */
+    g_test_calls = 0u;
+    BS_TEST_CHECK(gpio_notify_feed(BS_GPIO_PORT_A, U16_V) == 0u);
+    BS_TEST_CHECK(g_test_calls == 0u);
+
+    /* Pins 1 and 4 and 15 fall, pin 9 holds: the rising-only pin stays quiet */
+    g_test_calls = 0u;
+    BS_TEST_CHECK(gpio_notify_feed(BS_GPIO_PORT_A, (u16_t)~(SET_BIT(1u) | SET_BIT(4u) | SET_BIT(15u))) == 0u);
+    BS_TEST_CHECK(g_test_calls == 2u);
+    _test_expect(0u, BS_GPIO_PORT_A, 4u, FALSE);
+    _test_expect(1u, BS_GPIO_PORT_A, 15u, FALSE);
+
+    /* Other ports keep their own reference and filters */
+    g_test_calls = 0u;
+    BS_TEST_CHECK(gpio_notify_feed(BS_GPIO_PORT_B, U16_V) == 0u);
+    BS_TEST_CHECK(g_test_calls == 0u);
+}
+
+/* sync takes the current pin levels as the reference, so the first poll after it reports no edge the pins did not make */
+static void _test_sync(void)
+{
+    gpio_ctrl_1_t in = GPIO_CTRL_1_VAL(CTRL_INPUT, CTRL_PUSH_PULL, CTRL_SPEED_LEVEL_0, CTRL_FLOAT, CTRL_LOW, CTRL_AF_FUNC_0);
+
+    BS_TEST_CHECK(gpio_ctrl_1_set_mask(BS_GPIO_PORT_C, U16_V, in) == 0u);
+    bs_host_gpio_input(BS_GPIO_PORT_C, U16_V, SET_BIT(3u) | SET_BIT(8u));
+    _test_register(BS_GPIO_PORT_C, 3u, GPIO_NOTIFY_BOTH);
+    _test_register(BS_GPIO_PORT_C, 8u, GPIO_NOTIFY_RISING);
+
+    g_test_calls = 0u;
+    BS_TEST_CHECK(gpio_notify_sync(BS_GPIO_PORT_C) == 0u);
+    BS_TEST_CHECK(gpio_notify_poll(BS_GPIO_PORT_C) == 0u);
+    BS_TEST_CHECK(g_test_calls == 0u);
+
+    bs_host_gpio_input(BS_GPIO_PORT_C, SET_BIT(3u), 0u);
+    BS_TEST_CHECK(gpio_notify_poll(BS_GPIO_PORT_C) == 0u);
+    BS_TEST_CHECK(g_test_calls == 1u);
+    _test_expect(0u, BS_GPIO_PORT_C, 3u, FALSE);
+}
+
+/* An unregistered pin no longer dispatches while the others on the port still do */
+static void _test_unregister(void)
+{
+    BS_TEST_CHECK(gpio_notify_unregister(BS_GPIO_NUM(BS_GPIO_PORT_A, 9u)) == 0u);
+    BS_TEST_CHECK(gpio_notify_feed(BS_GPIO_PORT_A, 0x0000u) == 0u);
+
+    g_test_calls = 0u;
+    BS_TEST_CHECK(gpio_notify_feed(BS_GPIO_PORT_A, U16_V) == 0u);
+    BS_TEST_CHECK(g_test_calls == 2u);
+    _test_expect(0u, BS_GPIO_PORT_A, 1u, TRUE);
+    _test_expect(1u, BS_GPIO_PORT_A, 15u, TRUE);
+}
+
+static void _test_invalid(void)
+{
+    gpio_num_t bad_port = BS_GPIO_NUM(BS_GPIO_PORT_NUM, 0u);
+    gpio_num_t bad_pin = BS_GPIO_NUM(BS_GPIO_PORT_A, BS_GPIO_PIN_NUM);
+    gpio_num_t pin = BS_GPIO_NUM(BS_GPIO_PORT_B, 2u);
+
+    BS_TEST_CHECK(gpio_notify_register(bad_port, GPIO_NOTIFY_BOTH, _test_handler, NULL) == RESULT_INVALID_PORT);
+    BS_TEST_CHECK(gpio_notify_register(bad_pin, GPIO_NOTIFY_BOTH, _test_handler, NULL) == RESULT_INVALID_PIN);
+    BS_TEST_CHECK(gpio_notify_register(pin, GPIO_NOTIFY_BOTH, NULL, NULL) == RESULT_INVALID_ARGS);
+    BS_TEST_CHECK(gpio_notify_register(pin, 0u, _test_handler, NULL) == RESULT_INVALID_ARGS);
+    BS_TEST_CHECK(gpio_notify_unregister(bad_port) == RESULT_INVALID_PORT);
+    BS_TEST_CHECK(gpio_notify_unregister(bad_pin) == RESULT_INVALID_PIN);
+    BS_TEST_CHECK(gpio_notify_sync(BS_GPIO_PORT_NUM) == RESULT_INVALID_PORT);
+    BS_TEST_CHECK(gpio_notify_feed(BS_GPIO_PORT_NUM, 0u) == RESULT_INVALID_PORT);
+    BS_TEST_CHECK(gpio_notify_poll(BS_GPIO_PORT_NUM) == RESULT_INVALID_PORT);
+}
+
+int main(void)
+{
+    bs_host_gpio_reset();
+    _test_edges();
+    _test_sync();
+    _test_unregister();
+    _test_invalid();
+
+    printf("test_gpio_notify: ok\n");
+    return 0;
+}
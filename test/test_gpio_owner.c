@@ -0,0 +1,81 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "bsi_test.h"
+#include "bsi_gpio_owner.h"
+
+#define TEST_OWNER_SPI (0u)
+#define TEST_OWNER_LED (1u)
+
+/* The configuration calls run on behalf of the selected owner and reject pins another driver holds */
+static void _test_owner_aware(void)
+{
+    gpio_ctrl_1_t out = GPIO_CTRL_1_VAL(CTRL_OUTPUT, CTRL_PUSH_PULL, CTRL_SPEED_LEVEL_1, CTRL_FLOAT, CTRL_LOW, CTRL_AF_FUNC_0);
+    gpio_num_t led = BS_GPIO_NUM(BS_GPIO_PORT_C, 13u);
+    gpio_num_t cs = BS_GPIO_NUM(BS_GPIO_PORT_C, 4u);
+
+    BS_TEST_CHECK(gpio_ctrl_1_set(led, out) == RESULT_NOT_OWNED);
+    BS_TEST_CHECK(gpio_claim(led, TEST_OWNER_LED) == 0u);
+    BS_TEST_CHECK(gpio_claim(cs, TEST_OWNER_SPI) == 0u);
+
+    /* No owner selected, any claimed pin is accepted */
+    BS_TEST_CHECK(gpio_ctrl_1_set(led, out) == 0u);
+    BS_TEST_CHECK(gpio_ctrl_1_set(cs, out) == 0u);
+
+    BS_TEST_CHECK(gpio_owner_select(TEST_OWNER_SPI) == GPIO_OWNER_NONE);
+    BS_TEST_CHECK(gpio_ctrl_1_set(cs, out) == 0u);
+    BS_TEST_CHECK(gpio_ctrl_1_set(led, out) == RESULT_NOT_OWNED);
+    BS_TEST_CHECK(gpio_ctrl_1_set_mask(BS_GPIO_PORT_C, SET_BIT(4u) | SET_BIT(13u), out) == RESULT_NOT_OWNED);
+
+    BS_TEST_CHECK(gpio_owner_select(TEST_OWNER_LED) == TEST_OWNER_SPI);
+    BS_TEST_CHECK(gpio_ctrl_1_set(led, out) == 0u);
+    BS_TEST_CHECK(gpio_ctrl_1_set(cs, out) == RESULT_NOT_OWNED);
+    BS_TEST_CHECK(gpio_owner_select(GPIO_OWNER_NONE) == TEST_OWNER_LED);
+}
+
+/* A pin reserved for one alternate function rejects another one, and a second reservation with another number conflicts */
+static void _test_af_conflict(void)
+{
+    gpio_ctrl_1_t af5 = GPIO_CTRL_1_VAL(CTRL_AFIO, CTRL_PUSH_PULL, CTRL_SPEED_LEVEL_3, CTRL_FLOAT, CTRL_LOW, CTRL_AF_FUNC_5);
+    gpio_ctrl_1_t af7 = GPIO_CTRL_1_VAL(CTRL_AFIO, CTRL_PUSH_PULL, CTRL_SPEED_LEVEL_3, CTRL_FLOAT, CTRL_LOW, CTRL_AF_FUNC_7);
+    gpio_ctrl_1_t out = GPIO_CTRL_1_VAL(CTRL_OUTPUT, CTRL_PUSH_PULL, CTRL_SPEED_LEVEL_1, CTRL_FLOAT, CTRL_LOW, CTRL_AF_FUNC_7);
+    gpio_num_t sck = BS_GPIO_NUM(BS_GPIO_PORT_A, 5u);
+    gpio_num_t mosi = BS_GPIO_NUM(BS_GPIO_PORT_A, 12u);
+    gpio_num_t spare = BS_GPIO_NUM(BS_GPIO_PORT_A, 6u);
+
+    BS_TEST_CHECK(gpio_claim_af(sck, TEST_OWNER_SPI, CTRL_AF_FUNC_5) == 0u);
+    BS_TEST_CHECK(gpio_claim_af(mosi, TEST_OWNER_SPI, CTRL_AF_FUNC_5) == 0u);
+    BS_TEST_CHECK(gpio_claim(spare, TEST_OWNER_SPI) == 0u);
+    BS_TEST_CHECK(gpio_claim_af(sck, TEST_OWNER_SPI, CTRL_AF_FUNC_5) == 0u);
+    BS_TEST_CHECK(gpio_claim_af(sck, TEST_OWNER_SPI, CTRL_AF_FUNC_7) == RESULT_BUSY);
+    BS_TEST_CHECK(gpio_claim_af(sck, TEST_OWNER_LED, CTRL_AF_FUNC_5) == RESULT_BUSY);
+    BS_TEST_CHECK(gpio_claim_af(spare, TEST_OWNER_SPI, 16u) == RESULT_INVALID_ARGS);
+
+    BS_TEST_CHECK(gpio_ctrl_1_set(sck, af5) == 0u);
+    BS_TEST_CHECK(gpio_ctrl_1_set(sck, af7) == RESULT_BUSY);
+    BS_TEST_CHECK(gpio_ctrl_1_set(mosi, af7) == RESULT_BUSY);
+    BS_TEST_CHECK(gpio_ctrl_1_set_mask(BS_GPIO_PORT_A, SET_BIT(5u) | SET_BIT(12u), af5) == 0u);
+    BS_TEST_CHECK(gpio_ctrl_1_set_mask(BS_GPIO_PORT_A, SET_BIT(5u) | SET_BIT(6u) | SET_BIT(12u), af7) == RESULT_BUSY);
+
+    /* Parking the pin as a plain output is no function conflict, an unreserved pin takes any function */
+    BS_TEST_CHECK(gpio_ctrl_1_set(sck, out) == 0u);
+    BS_TEST_CHECK(gpio_ctrl_1_set(spare, af7) == 0u);
+
+    /* The release drops the reservation with the claim */
+    BS_TEST_CHECK(gpio_release(sck, TEST_OWNER_SPI) == 0u);
+    BS_TEST_CHECK(gpio_claim(sck, TEST_OWNER_SPI) == 0u);
+    BS_TEST_CHECK(gpio_ctrl_1_set(sck, af7) == 0u);
+}
+
+int main(void)
+{
+    bs_host_gpio_reset();
+    _test_owner_aware();
+    _test_af_conflict();
+
+    printf("test_gpio_owner: ok\n");
+    return 0;
+}
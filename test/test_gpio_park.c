@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "bsi_test.h"
+
+#define TEST_TRIALS (5000u)
+
+/* The field of a pin in a configuration register, all ones for the pins the register does not hold */
+static u32_t _test_field_mask(gpio_pin_t pin, u32_t width, gpio_pin_t first)
+{
+    if ((pin < first) || ((u32_t)(pin - first) >= (32u / width))) {
+        return 0u;
+    }
+    return MASK_BIT(width) << ((pin - first) * width);
+}
+
+/* Park the unused pins for sleep and wake up again: the used pins never change and the restore brings back every register */
+static void _test_park(void)
+{
+    u32_t state = 0x9B05688Cu;
+    u32_t loads, stores;
+
+    bs_host_gpio_reset();
+    for (u32_t trial = 0u; trial < TEST_TRIALS; trial++) {
+        gpio_regs_t saved[BS_GPIO_PORT_NUM];
+        gpio_ctrl_1_t settings[BS_GPIO_PORT_NUM][BS_GPIO_PIN_NUM];
+        gpio_snapshot_t snap, park;
+        u16_t used[BS_GPIO_PORT_NUM];
+
+        for (gpio_port_t port = 0u; port < BS_GPIO_PORT_NUM; port++) {
+            gpio_regs_t *pGpioRegs = bs_host_gpio_regs(port);
+#define TEST_RANDOM_REG(reg, width, first) pGpioRegs->reg = bs_test_random(&state);
+            GPIO_CFG_REGS(TEST_RANDOM_REG)
+#undef TEST_RANDOM_REG
+            pGpioRegs->out_ctrl = bs_test_random(&state) & U16_V;
+            bs_host_gpio_sync(port);
+            memcpy(&saved[port], (const void *)pGpioRegs, sizeof(gpio_regs_t));
+            BS_TEST_CHECK(gpio_port_decode(port, settings[port]) == 0u);
+            used[port] = (u16_t)bs_test_random(&state);
+        }
+
+        BS_TEST_CHECK(gpio_snapshot(&snap) == 0u);
+        park = snap;
+
+        /* Parking edits the snapshot in RAM and touches no register */
+        bs_host_reg_count(NULL, NULL);
+        BS_TEST_CHECK(gpio_snapshot_park(&park, used) == 0u);
+        bs_host_reg_count(&loads, &stores);
+        BS_TEST_CHECK((loads == 0u) && (stores == 0u));
+
+        BS_TEST_CHECK(gpio_restore(&park) == 0u);
+        for (gpio_port_t port = 0u; port < BS_GPIO_PORT_NUM; port++) {
+            gpio_regs_t *pGpioRegs = bs_host_gpio_regs(port);
+            gpio_ctrl_1_t parked[BS_GPIO_PIN_NUM];
+
+            BS_TEST_CHECK(gpio_port_decode(port, parked) == 0u);
+            BS_TEST_CHECK(pGpioRegs->out_ctrl == saved[port].out_ctrl);
+            for (gpio_pin_t pin = 0u; pin < BS_GPIO_PIN_NUM; pin++) {
+                if (used[port] & SET_BIT(pin)) {
+#define TEST_SAME_FIELD(reg, width, first)                                                                                                 \
+    BS_TEST_CHECK(!((pGpioRegs->reg ^ saved[port].reg) & _test_field_mask(pin, width, first)));
+                    GPIO_CFG_REGS(TEST_SAME_FIELD)
+#undef TEST_SAME_FIELD
+                    BS_TEST_CHECK(parked[pin].value == settings[port][pin].value);
+                } else {
+                    BS_TEST_CHECK(parked[pin].bits.in_out == CTRL_ANALOG);
+                    BS_TEST_CHECK(parked[pin].bits.up_down == CTRL_FLOAT);
+                }
+            }
+        }
+
+        /* Waking up restores the exact registers of the snapshot */
+        BS_TEST_CHECK(gpio_restore(&snap) == 0u);
+        for (gpio_port_t port = 0u; port < BS_GPIO_PORT_NUM; port++) {
+            BS_TEST_CHECK(!memcmp((const void *)bs_host_gpio_regs(port), (const void *)&saved[port], sizeof(gpio_regs_t)));
+        }
+    }
+}
+
+static void _test_park_invalid(void)
+{
+    gpio_snapshot_t snap;
+    u16_t used[BS_GPIO_PORT_NUM] = {0u};
+
+    BS_TEST_CHECK(gpio_snapshot_park(NULL, used) == RESULT_INVALID_ARGS);
+    BS_TEST_CHECK(gpio_snapshot_park(&snap, NULL) == RESULT_INVALID_ARGS);
+}
+
+int main(void)
+{
+    _test_park();
+    _test_park_invalid();
+
+    printf("test_gpio_park: ok\n");
+    return 0;
+}
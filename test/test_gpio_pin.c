@@ -0,0 +1,87 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "bsi_test.h"
+
+#define TEST_TRIALS (20000u)
+
+/* Every pin write is one store to an action register and reads nothing, except the toggle of a port without a toggle register */
+static void _test_accesses(u32_t expect_loads)
+{
+    u32_t loads, stores;
+
+    bs_host_reg_count(&loads, &stores);
+    BS_TEST_CHECK((loads == expect_loads) && (stores == 1u));
+}
+
+/* Random pin writes on every port against a model of the output latch */
+static void _test_pin_writes(void)
+{
+    u16_t latch[BS_GPIO_PORT_NUM] = {0u};
+    u32_t state = 0x3C6EF372u;
+
+    bs_host_gpio_reset();
+    bs_host_reg_count(NULL, NULL);
+
+    for (u32_t trial = 0u; trial < TEST_TRIALS; trial++) {
+        u32_t r = bs_test_random(&state);
+        gpio_port_t port = (gpio_port_t)(r % BS_GPIO_PORT_NUM);
+        gpio_pin_t pin = (gpio_pin_t)((r >> 8u) % BS_GPIO_PIN_NUM);
+        gpio_num_t port_pin = BS_GPIO_NUM(port, pin);
+        u16_t bit = (u16_t)SET_BIT(pin);
+        u32_t loads = 0u;
+
+        switch ((r >> 16u) & 0x3u) {
+        case 0u:
+            BS_TEST_CHECK(gpio_set(port_pin) == 0u);
+            latch[port] |= bit;
+            break;
+        case 1u:
+            BS_TEST_CHECK(gpio_clear(port_pin) == 0u);
+            latch[port] &= (u16_t)~bit;
+            break;
+        case 2u:
+            BS_TEST_CHECK(gpio_toggle(port_pin) == 0u);
+            latch[port] ^= bit;
+            loads = BS_GPIO_HAS_TOGGLE ? 0u : 1u;
+            break;
+        default:
+            BS_TEST_CHECK(gpio_write(port_pin, (r >> 20u) & 1u) == 0u);
+            latch[port] = ((r >> 20u) & 1u) ? (latch[port] | bit) : (latch[port] & (u16_t)~bit);
+            break;
+        }
+        _test_accesses(loads);
+
+        for (gpio_port_t p = 0u; p < BS_GPIO_PORT_NUM; p++) {
+            BS_TEST_CHECK(bs_host_gpio_regs(p)->out_ctrl == latch[p]);
+        }
+    }
+}
+
+/* An invalid pin is rejected before any register access */
+static void _test_pin_invalid(void)
+{
+    gpio_num_t bad_port = BS_GPIO_NUM(BS_GPIO_PORT_NUM, 0u);
+    gpio_num_t bad_pin = BS_GPIO_NUM(BS_GPIO_PORT_A, BS_GPIO_PIN_NUM);
+    u32_t loads, stores;
+
+    bs_host_reg_count(NULL, NULL);
+    BS_TEST_CHECK(gpio_set(bad_port) == RESULT_INVALID_PORT);
+    BS_TEST_CHECK(gpio_clear(bad_pin) == RESULT_INVALID_PIN);
+    BS_TEST_CHECK(gpio_toggle(bad_port) == RESULT_INVALID_PORT);
+    BS_TEST_CHECK(gpio_write(bad_pin, TRUE) == RESULT_INVALID_PIN);
+    bs_host_reg_count(&loads, &stores);
+    BS_TEST_CHECK((loads == 0u) && (stores == 0u));
+}
+
+int main(void)
+{
+    _test_pin_writes();
+    _test_pin_invalid();
+
+    printf("test_gpio_pin: ok\n");
+    return 0;
+}
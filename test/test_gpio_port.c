@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "bsi_test.h"
+
+#define TEST_TRIALS (20000u)
+
+/* The configuration registers stay as they were, a port write only acts on the output latch */
+static void _test_cfg_same(const gpio_regs_t *pGpioRegs, const gpio_regs_t *pSaved)
+{
+#define TEST_SAME_REG(reg, width, first) BS_TEST_CHECK(pGpioRegs->reg == pSaved->reg);
+    GPIO_CFG_REGS(TEST_SAME_REG)
+#undef TEST_SAME_REG
+}
+
+/* A masked write drives the masked pins to the value bits with one bit_op store and leaves the other pins of the latch alone */
+static void _test_write_masked(void)
+{
+    u32_t state = 0xA54FF53Au;
+    u32_t loads, stores;
+
+    bs_host_gpio_reset();
+    for (u32_t trial = 0u; trial < TEST_TRIALS; trial++) {
+        gpio_port_t port = (gpio_port_t)(bs_test_random(&state) % BS_GPIO_PORT_NUM);
+        gpio_regs_t *pGpioRegs = bs_host_gpio_regs(port);
+        u16_t latch = (u16_t)bs_test_random(&state);
+        u16_t mask = (u16_t)bs_test_random(&state);
+        u16_t value = (u16_t)bs_test_random(&state);
+        gpio_regs_t saved;
+
+#define TEST_RANDOM_REG(reg, width, first) pGpioRegs->reg = bs_test_random(&state);
+        GPIO_CFG_REGS(TEST_RANDOM_REG)
+#undef TEST_RANDOM_REG
+        pGpioRegs->out_ctrl = latch;
+        memcpy(&saved, (const void *)pGpioRegs, sizeof(gpio_regs_t));
+
+        bs_host_reg_count(NULL, NULL);
+        BS_TEST_CHECK(gpio_port_write_masked(port, mask, value) == 0u);
+        bs_host_reg_count(&loads, &stores);
+        BS_TEST_CHECK((loads == 0u) && (stores == 1u));
+
+        BS_TEST_CHECK(pGpioRegs->out_ctrl == (u32_t)((latch & (u16_t)~mask) | (value & mask)));
+        BS_TEST_CHECK(pGpioRegs->bit_op == 0u);
+        _test_cfg_same(pGpioRegs, &saved);
+    }
+
+    bs_host_reg_count(NULL, NULL);
+    BS_TEST_CHECK(gpio_port_write_masked(BS_GPIO_PORT_NUM, U16_V, 0u) == RESULT_INVALID_PORT);
+    bs_host_reg_count(&loads, &stores);
+    BS_TEST_CHECK((loads == 0u) && (stores == 0u));
+}
+
+/* The outputs read back their latch and the inputs the injected level, one in_status load returns the whole port */
+static void _test_read(void)
+{
+    gpio_ctrl_1_t in = GPIO_CTRL_1_VAL(CTRL_INPUT, CTRL_PUSH_PULL, CTRL_SPEED_LEVEL_0, CTRL_FLOAT, CTRL_LOW, CTRL_AF_FUNC_0);
+    gpio_ctrl_1_t out = GPIO_CTRL_1_VAL(CTRL_OUTPUT, CTRL_PUSH_PULL, CTRL_SPEED_LEVEL_1, CTRL_FLOAT, CTRL_LOW, CTRL_AF_FUNC_0);
+    u32_t state = 0x510E527Fu;
+    u32_t loads, stores;
+
+    bs_host_gpio_reset();
+    for (u32_t trial = 0u; trial < (TEST_TRIALS / 16u); trial++) {
+        gpio_port_t port = (gpio_port_t)(bs_test_random(&state) % BS_GPIO_PORT_NUM);
+        u16_t outputs = (u16_t)((bs_test_random(&state) & 0x7FFFu) | 0x0001u);
+        u16_t latch = (u16_t)bs_test_random(&state);
+        u16_t input = (u16_t)bs_test_random(&state);
+        u16_t mask = (u16_t)bs_test_random(&state);
+        u16_t level = (latch & outputs) | (input & (u16_t)~outputs);
+
+        BS_TEST_CHECK(gpio_ctrl_1_set_mask(port, (u16_t)~outputs, in) == 0u);
+        BS_TEST_CHECK(gpio_ctrl_1_set_mask(port, outputs, out) == 0u);
+        BS_TEST_CHECK(gpio_port_write_masked(port, U16_V, latch) == 0u);
+        bs_host_gpio_input(port, U16_V, input);
+
+        bs_host_reg_count(NULL, NULL);
+        BS_TEST_CHECK(gpio_port_read(port) == level);
+        bs_host_reg_count(&loads, &stores);
+        BS_TEST_CHECK((loads == 1u) && (stores == 0u));
+
+        BS_TEST_CHECK(gpio_port_read_masked(port, mask) == (level & mask));
+        bs_host_reg_count(&loads, &stores);
+        BS_TEST_CHECK((loads == 1u) && (stores == 0u));
+    }
+
+    bs_host_reg_count(NULL, NULL);
+    BS_TEST_CHECK(gpio_port_read(BS_GPIO_PORT_NUM) == 0u);
+    BS_TEST_CHECK(gpio_port_read_masked(BS_GPIO_PORT_NUM, U16_V) == 0u);
+    bs_host_reg_count(&loads, &stores);
+    BS_TEST_CHECK((loads == 0u) && (stores == 0u));
+}
+
+int main(void)
+{
+    _test_write_masked();
+    _test_read();
+
+    printf("test_gpio_port: ok\n");
+    return 0;
+}
@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "bsi_test.h"
+
+/* Fill every register of the ports with a pattern so a stray store to any of them shows */
+static void _test_fill(gpio_regs_t *pSaved, u32_t *pState)
+{
+    for (gpio_port_t port = 0u; port < BS_GPIO_PORT_NUM; port++) {
+        gpio_regs_t *pGpioRegs = bs_host_gpio_regs(port);
+        for (u32_t i = 0u; i < (sizeof(gpio_regs_t) / sizeof(u32_t)); i++) {
+            ((vu32_t *)pGpioRegs)[i] = (i == (offsetof(gpio_regs_t, bit_op) / sizeof(u32_t))) ? 0u : bs_test_random(pState);
+        }
+        memcpy(&pSaved[port], (const void *)pGpioRegs, sizeof(gpio_regs_t));
+    }
+}
+
+/* Secure and non-secure masks of one port, the pins out of the mask and the other ports keep their assignment */
+static void _test_assign(void)
+{
+    u32_t state = 0x5EC0BE17u;
+    u32_t loads, stores;
+
+    for (u32_t i = 0u; i < 1000u; i++) {
+        gpio_port_t port = (gpio_port_t)(bs_test_random(&state) % BS_GPIO_PORT_NUM);
+        u16_t mask = (u16_t)bs_test_random(&state);
+        b_t secure = (bs_test_random(&state) & 1u) ? TRUE : FALSE;
+        u16_t before[BS_GPIO_PORT_NUM];
+
+        for (gpio_port_t p = 0u; p < BS_GPIO_PORT_NUM; p++) {
+            before[p] = gpio_secure_query(p);
+        }
+
+        BS_TEST_CHECK(gpio_secure_assign(port, mask, secure) == 0u);
+        for (gpio_port_t p = 0u; p < BS_GPIO_PORT_NUM; p++) {
+            u16_t expect = (p != port) ? before[p] : (u16_t)(secure ? (before[p] | mask) : (before[p] & ~mask));
+            BS_TEST_CHECK(gpio_secure_query(p) == expect);
+            BS_TEST_CHECK(bs_host_gpio_regs(p)->secure == expect);
+        }
+    }
+
+    /* The whole port is one store with no read back */
+    bs_host_reg_count(NULL, NULL);
+    BS_TEST_CHECK(gpio_secure_assign(BS_GPIO_PORT_B, U16_V, TRUE) == 0u);
+    bs_host_reg_count(&loads, &stores);
+    BS_TEST_CHECK((loads == 0u) && (stores == 1u));
+    BS_TEST_CHECK(gpio_secure_query(BS_GPIO_PORT_B) == U16_V);
+    BS_TEST_CHECK(gpio_secure_assign(BS_GPIO_PORT_B, U16_V, FALSE) == 0u);
+    BS_TEST_CHECK(gpio_secure_query(BS_GPIO_PORT_B) == 0u);
+
+    BS_TEST_CHECK(gpio_secure_assign(BS_GPIO_PORT_NUM, U16_V, TRUE) == RESULT_INVALID_PORT);
+    BS_TEST_CHECK(gpio_secure_query(BS_GPIO_PORT_NUM) == 0u);
+}
+
+/* The boot-time partition stores the secure register of every port once and touches nothing else */
+static void _test_apply(void)
+{
+    static const u16_t secure[BS_GPIO_PORT_NUM] = {0x00FFu, 0xA5A5u, 0x8001u};
+    gpio_regs_t saved[BS_GPIO_PORT_NUM];
+    u32_t state = 0x0DDBA11u;
+    u32_t loads, stores;
+
+    _test_fill(saved, &state);
+    bs_host_reg_count(NULL, NULL);
+    BS_TEST_CHECK(gpio_secure_apply(secure) == 0u);
+    bs_host_reg_count(&loads, &stores);
+    BS_TEST_CHECK((loads == 0u) && (stores == BS_GPIO_PORT_NUM));
+
+    for (gpio_port_t port = 0u; port < BS_GPIO_PORT_NUM; port++) {
+        saved[port].secure = secure[port];
+        BS_TEST_CHECK(!memcmp((const void *)bs_host_gpio_regs(port), (const void *)&saved[port], sizeof(gpio_regs_t)));
+        BS_TEST_CHECK(gpio_secure_query(port) == secure[port]);
+    }
+
+    BS_TEST_CHECK(gpio_secure_apply(NULL) == RESULT_INVALID_ARGS);
+}
+
+int main(void)
+{
+    bs_host_gpio_reset();
+    _test_assign();
+    _test_apply();
+
+    printf("test_gpio_secure: ok\n");
+    return 0;
+}
@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include <pthread.h>
+#include "bsi_test.h"
+
+#define TEST_THREADS    (4u)
+#define TEST_PINS       (BS_GPIO_PIN_NUM / TEST_THREADS)
+#define TEST_SETTINGS   (32u)
+#define TEST_ITERATIONS (200000u)
+
+/* Valid settings with the setting gpio_ctrl_1_get reads back for each, the decode folds the encodings a family cannot tell apart */
+static gpio_ctrl_1_t g_test_settings[TEST_SETTINGS];
+static gpio_ctrl_1_t g_test_decoded[TEST_SETTINGS];
+
+/* The index of the setting last written to each pin of port A, every pin has exactly one writer */
+static u8_t g_test_last[BS_GPIO_PIN_NUM];
+
+static void _test_settings(void)
+{
+    gpio_num_t probe = BS_GPIO_NUM(BS_GPIO_PORT_B, 0u);
+    gpio_update_t update;
+    u32_t state = 0x2545F491u;
+
+    for (u32_t n = 0u; n < TEST_SETTINGS;) {
+        gpio_ctrl_1_t setting = bs_test_setting(&state);
+        if (gpio_ctrl_1_encode(1u, setting, &update)) {
+            continue;
+        }
+        BS_TEST_CHECK(gpio_ctrl_1_set(probe, setting) == 0u);
+        BS_TEST_CHECK(gpio_ctrl_1_get(probe, &g_test_decoded[n]) == 0u);
+        g_test_settings[n++] = setting;
+    }
+}
+
+/* Reconfigure the pins of one thread in a tight loop, every read back must see the setting just written */
+static void *_test_worker(void *pArg)
+{
+    u32_t first = (u32_t)(uptr_t)pArg * TEST_PINS;
+    u32_t state = 0x9E3779B9u ^ first;
+
+    for (u32_t i = 0u; i < TEST_ITERATIONS; i++) {
+        u32_t r = bs_test_random(&state);
+        gpio_pin_t pin = (gpio_pin_t)(first + (r % TEST_PINS));
+        u8_t k = (u8_t)((r >> 8u) % TEST_SETTINGS);
+        gpio_num_t port_pin = BS_GPIO_NUM(BS_GPIO_PORT_A, pin);
+        gpio_ctrl_1_t setting;
+
+        BS_TEST_CHECK(gpio_ctrl_1_set(port_pin, g_test_settings[k]) == 0u);
+        BS_TEST_CHECK(gpio_ctrl_1_get(port_pin, &setting) == 0u);
+        BS_TEST_CHECK(setting.value == g_test_decoded[k].value);
+        g_test_last[pin] = k;
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    pthread_t threads[TEST_THREADS];
+
+    bs_host_gpio_reset();
+    _test_settings();
+
+    for (u32_t t = 0u; t < TEST_THREADS; t++) {
+        BS_TEST_CHECK(pthread_create(&threads[t], NULL, _test_worker, (void *)(uptr_t)t) == 0);
+    }
+    for (u32_t t = 0u; t < TEST_THREADS; t++) {
+        BS_TEST_CHECK(pthread_join(threads[t], NULL) == 0);
+    }
+
+    /* No update of any thread was lost once all of them are done */
+    for (gpio_pin_t pin = 0u; pin < BS_GPIO_PIN_NUM; pin++) {
+        gpio_ctrl_1_t setting;
+        BS_TEST_CHECK(gpio_ctrl_1_get(BS_GPIO_NUM(BS_GPIO_PORT_A, pin), &setting) == 0u);
+        BS_TEST_CHECK(setting.value == g_test_decoded[g_test_last[pin]].value);
+    }
+
+    printf("test_gpio_stress: ok\n");
+    return 0;
+}
@@ -0,0 +1,126 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "bsi_test.h"
+
+static gpio_trace_entry_t g_test_entries[BS_GPIO_TRACE_SIZE];
+
+/* Drive a random mix of configuration and level calls, returning the register stores they issued */
+static u32_t _test_drive(u32_t calls, u32_t *pState)
+{
+    u32_t stores;
+
+    bs_host_reg_count(NULL, NULL);
+    for (u32_t i = 0u; i < calls; i++) {
+        u32_t r = bs_test_random(pState);
+        gpio_num_t port_pin = BS_GPIO_NUM(r % BS_GPIO_PORT_NUM, (r >> 8u) & 15u);
+
+        if (r & SET_BIT(16u)) {
+            gpio_ctrl_1_set(port_pin, bs_test_setting(pState));
+        } else {
+            gpio_set(port_pin);
+        }
+    }
+    bs_host_reg_count(NULL, &stores);
+    return stores;
+}
+
+static void _test_regs_equal(const gpio_regs_t *pSaved)
+{
+    for (gpio_port_t port = 0u; port < BS_GPIO_PORT_NUM; port++) {
+        BS_TEST_CHECK(!memcmp((const void *)bs_host_gpio_regs(port), (const void *)&pSaved[port], sizeof(gpio_regs_t)));
+    }
+}
+
+/* A recording that fits the ring replays onto reset registers into exactly the registers it was taken from */
+static void _test_replay(void)
+{
+    gpio_regs_t saved[BS_GPIO_PORT_NUM];
+    u32_t state = 0x13579BDFu;
+    u32_t stores;
+
+    do {
+        bs_host_gpio_reset();
+        gpio_trace_reset();
+        stores = _test_drive(12u, &state);
+    } while (stores > BS_GPIO_TRACE_SIZE);
+    for (gpio_port_t port = 0u; port < BS_GPIO_PORT_NUM; port++) {
+        saved[port] = *bs_host_gpio_regs(port);
+    }
+
+    u32_t num = gpio_trace_read(g_test_entries, BS_GPIO_TRACE_SIZE);
+    BS_TEST_CHECK((num == stores) && (num > 0u));
+    for (u32_t i = 0u; i < num; i++) {
+        BS_TEST_CHECK(g_test_entries[i].seq == (u16_t)i);
+        BS_TEST_CHECK((i == 0u) || (g_test_entries[i].timestamp > g_test_entries[i - 1u].timestamp));
+    }
+
+    bs_host_gpio_reset();
+    BS_TEST_CHECK(bs_host_trace_replay(g_test_entries, num) == num);
+    _test_regs_equal(saved);
+}
+
+/* Past BS_GPIO_TRACE_SIZE stores the ring keeps the newest ones oldest first, ending with the last store issued */
+static void _test_wrap(void)
+{
+    u32_t state = 0x2468ACE0u;
+
+    bs_host_gpio_reset();
+    gpio_trace_reset();
+    u32_t stores = _test_drive(BS_GPIO_TRACE_SIZE, &state);
+    BS_TEST_CHECK(stores > BS_GPIO_TRACE_SIZE);
+    BS_TEST_CHECK(gpio_set(BS_GPIO_NUM(BS_GPIO_PORT_C, 7u)) == 0u);
+    stores++;
+
+    BS_TEST_CHECK(gpio_trace_read(g_test_entries, BS_GPIO_TRACE_SIZE + 8u) == BS_GPIO_TRACE_SIZE);
+    for (u32_t i = 0u; i < BS_GPIO_TRACE_SIZE; i++) {
+        BS_TEST_CHECK(g_test_entries[i].seq == (u16_t)(stores - BS_GPIO_TRACE_SIZE + i));
+    }
+
+    const gpio_trace_entry_t *pLast = &g_test_entries[BS_GPIO_TRACE_SIZE - 1u];
+    BS_TEST_CHECK((pLast->port == BS_GPIO_PORT_C) && (pLast->offset == offsetof(gpio_regs_t, bit_op)) && (pLast->value == SET_BIT(7u)));
+
+    /* A shorter read returns the newest entries */
+    BS_TEST_CHECK(gpio_trace_read(g_test_entries, 1u) == 1u);
+    BS_TEST_CHECK(g_test_entries[0].seq == (u16_t)(stores - 1u));
+}
+
+/* A partial register update records the merged register content, and a commit leaving the registers as they are records nothing */
+static void _test_modify(void)
+{
+    gpio_ctrl_1_t afio = GPIO_CTRL_1_VAL(CTRL_AFIO, CTRL_OPEN_DRAIN, CTRL_SPEED_LEVEL_2, CTRL_PULL_UP, CTRL_HIGH, CTRL_AF_FUNC_9);
+    gpio_num_t port_pin = BS_GPIO_NUM(BS_GPIO_PORT_B, 10u);
+    gpio_regs_t *pGpioRegs = bs_host_gpio_regs(BS_GPIO_PORT_B);
+    u8_t writes;
+
+    bs_host_gpio_reset();
+    gpio_trace_reset();
+    BS_TEST_CHECK((gpio_ctrl_1_apply(port_pin, afio, &writes) == 0u) && (writes > 0u));
+
+    u32_t num = gpio_trace_read(g_test_entries, BS_GPIO_TRACE_SIZE);
+    BS_TEST_CHECK(num == writes);
+    for (u32_t i = 0u; i < num; i++) {
+        const gpio_trace_entry_t *pEntry = &g_test_entries[i];
+        BS_TEST_CHECK(pEntry->port == BS_GPIO_PORT_B);
+        if (pEntry->offset != offsetof(gpio_regs_t, bit_op)) {
+            BS_TEST_CHECK(pEntry->value == *(vu32_t *)((u8_t *)pGpioRegs + pEntry->offset));
+        }
+    }
+
+    gpio_trace_reset();
+    BS_TEST_CHECK((gpio_ctrl_1_apply(port_pin, afio, &writes) == 0u) && (writes == 0u));
+    BS_TEST_CHECK(gpio_trace_read(g_test_entries, BS_GPIO_TRACE_SIZE) == 0u);
+}
+
+int main(void)
+{
+    _test_replay();
+    _test_wrap();
+    _test_modify();
+
+    printf("test_gpio_trace: ok\n");
+    return 0;
+}
@@ -0,0 +1,126 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "bsi_test.h"
+#include "bsi_gpio_verify.h"
+
+/* A pin switched by the direction helpers verifies clean, while the other fields of the port are still compared */
+static void _test_dir_release(void)
+{
+    gpio_ctrl_1_t out = GPIO_CTRL_1_VAL(CTRL_OUTPUT, CTRL_OPEN_DRAIN, CTRL_SPEED_LEVEL_1, CTRL_FLOAT, CTRL_HIGH, CTRL_AF_FUNC_0);
+    gpio_ctrl_1_t in = GPIO_CTRL_1_VAL(CTRL_INPUT, CTRL_PUSH_PULL, CTRL_SPEED_LEVEL_0, CTRL_FLOAT, CTRL_LOW, CTRL_AF_FUNC_0);
+    gpio_num_t sda = BS_GPIO_NUM(BS_GPIO_PORT_B, 9u);
+    gpio_num_t other = BS_GPIO_NUM(BS_GPIO_PORT_B, 2u);
+    gpio_dir_t dir;
+    u16_t pins;
+
+    BS_TEST_CHECK(gpio_ctrl_1_set(sda, out) == 0u);
+    BS_TEST_CHECK(gpio_ctrl_1_set(other, in) == 0u);
+    BS_TEST_CHECK(gpio_dir_init(&dir, sda) == 0u);
+
+    gpio_dir_in(&dir);
+    BS_TEST_CHECK((gpio_verify_port(BS_GPIO_PORT_B, &pins) == 0u) && (pins == 0u));
+    gpio_dir_out(&dir);
+    BS_TEST_CHECK((gpio_verify_port(BS_GPIO_PORT_B, &pins) == 0u) && (pins == 0u));
+    gpio_dir_in(&dir);
+
+    /* Reconfiguring the pin behind the BSI layer still reports the other pin */
+    gpio_regs_t *pGpioRegs = bs_host_gpio_regs(BS_GPIO_PORT_B);
+    gpio_update_t tamper;
+    BS_TEST_CHECK(gpio_ctrl_1_encode(SET_BIT(2u), out, &tamper) == 0u);
+#define TEST_TAMPER_REG(reg, width, first) pGpioRegs->reg = gpio_field_merge(pGpioRegs->reg, &tamper.reg);
+    GPIO_CFG_REGS(TEST_TAMPER_REG)
+#undef TEST_TAMPER_REG
+    BS_TEST_CHECK((gpio_verify_port(BS_GPIO_PORT_B, &pins) == RESULT_MISMATCH) && (pins == SET_BIT(2u)));
+
+    /* A commit on the direction pin expects its field again */
+    BS_TEST_CHECK(gpio_ctrl_1_set(other, in) == 0u);
+    BS_TEST_CHECK(gpio_ctrl_1_set(sda, out) == 0u);
+    gpio_dir_in(&dir);
+    BS_TEST_CHECK((gpio_verify_port(BS_GPIO_PORT_B, &pins) == RESULT_MISMATCH) && (pins == SET_BIT(9u)));
+    BS_TEST_CHECK(gpio_dir_init(&dir, sda) == 0u);
+    BS_TEST_CHECK((gpio_verify_port(BS_GPIO_PORT_B, &pins) == 0u) && (pins == 0u));
+}
+
+#define TEST_COUNT_REG(reg, width, first) +1u
+#define TEST_REG_NUM (0u GPIO_CFG_REGS(TEST_COUNT_REG))
+
+/* Each step compares one register, the registers of a port in order and then the next port, wrapping after the last one */
+static void _test_step(void)
+{
+    gpio_ctrl_1_t in = GPIO_CTRL_1_VAL(CTRL_INPUT, CTRL_PUSH_PULL, CTRL_SPEED_LEVEL_0, CTRL_PULL_UP, CTRL_LOW, CTRL_AF_FUNC_0);
+    gpio_ctrl_1_t out = GPIO_CTRL_1_VAL(CTRL_OUTPUT, CTRL_OPEN_DRAIN, CTRL_SPEED_LEVEL_1, CTRL_FLOAT, CTRL_HIGH, CTRL_AF_FUNC_0);
+    gpio_port_t port;
+    u16_t pins;
+
+    for (gpio_port_t p = 0u; p < BS_GPIO_PORT_NUM; p++) {
+        BS_TEST_CHECK(gpio_ctrl_1_set_mask(p, 0x00FFu, in) == 0u);
+    }
+
+    /* The step cursor starts at the first register of port A, this test runs first */
+    for (u32_t lap = 0u; lap < 2u; lap++) {
+        for (u32_t step = 0u; step < (TEST_REG_NUM * BS_GPIO_PORT_NUM); step++) {
+            BS_TEST_CHECK((gpio_verify_step(&port, &pins) == 0u) && (pins == 0u));
+            BS_TEST_CHECK(port == (step / TEST_REG_NUM));
+        }
+    }
+
+    /* A pin reconfigured behind the BSI layer shows up in exactly one step of a lap */
+    gpio_regs_t *pGpioRegs = bs_host_gpio_regs(BS_GPIO_PORT_B);
+    gpio_update_t tamper;
+    BS_TEST_CHECK(gpio_ctrl_1_encode(SET_BIT(6u), out, &tamper) == 0u);
+    *GPIO_DIR_CTRL(pGpioRegs, 6u) = gpio_field_merge(*GPIO_DIR_CTRL(pGpioRegs, 6u), GPIO_DIR_CTRL(&tamper, 6u));
+
+    u32_t reported = 0u;
+    for (u32_t step = 0u; step < (TEST_REG_NUM * BS_GPIO_PORT_NUM); step++) {
+        u32_t result = gpio_verify_step(&port, &pins);
+        if (result) {
+            BS_TEST_CHECK((result == RESULT_MISMATCH) && (port == BS_GPIO_PORT_B) && (pins == SET_BIT(6u)));
+            reported++;
+        }
+    }
+    BS_TEST_CHECK(reported == 1u);
+    BS_TEST_CHECK(gpio_ctrl_1_set(BS_GPIO_NUM(BS_GPIO_PORT_B, 6u), in) == 0u);
+}
+
+/* A bit flipped in the record fails its CRC, so the difference is reported as a corrupted record with all pins */
+static void _test_corrupted(void)
+{
+    gpio_field_t *pRecord = bs_host_verify_record(BS_GPIO_PORT_C);
+    u16_t pins;
+
+    BS_TEST_CHECK((gpio_verify_port(BS_GPIO_PORT_C, &pins) == 0u) && (pins == 0u));
+    u32_t index = 0u;
+    while (!pRecord[index].mask) {
+        index++;
+    }
+    u32_t flip = pRecord[index].mask & (~pRecord[index].mask + 1u);
+
+    pRecord[index].value ^= flip;
+    BS_TEST_CHECK((gpio_verify_port(BS_GPIO_PORT_C, &pins) == RESULT_CORRUPTED) && (pins == U16_V));
+
+    gpio_port_t port = BS_GPIO_PORT_A;
+    u32_t result = 0u;
+    for (u32_t step = 0u; (step < (TEST_REG_NUM * BS_GPIO_PORT_NUM)) && !result; step++) {
+        result = gpio_verify_step(&port, &pins);
+    }
+    BS_TEST_CHECK((result == RESULT_CORRUPTED) && (port == BS_GPIO_PORT_C) && (pins == U16_V));
+
+    pRecord[index].value ^= flip;
+    BS_TEST_CHECK((gpio_verify_port(BS_GPIO_PORT_C, &pins) == 0u) && (pins == 0u));
+    BS_TEST_CHECK(gpio_verify_port(BS_GPIO_PORT_NUM, &pins) == RESULT_INVALID_PORT);
+}
+
+int main(void)
+{
+    bs_host_gpio_reset();
+    _test_step();
+    _test_corrupted();
+    _test_dir_release();
+
+    printf("test_gpio_verify: ok\n");
+    return 0;
+}
@@ -0,0 +1,113 @@
+/**
+ * Copyright (c) Riven Zheng (zhengheiot@gmail.com).
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ **/
+#include "bsi_test.h"
+#include "bsi_gpio_wave.h"
+
+#define TEST_LENGTH (240u)
+#define TEST_PINS   (3u)
+#define TEST_EDGES  (24u)
+
+/* The out_ctrl of port C at every time slot of the playback */
+static u16_t g_test_played[TEST_LENGTH];
+static u32_t g_test_slot = 0u;
+
+static void _test_wait(u32_t slots)
+{
+    gpio_regs_t *pGpioRegs = bs_host_gpio_regs(BS_GPIO_PORT_C);
+
+    for (u32_t n = 0u; (n < slots) && (g_test_slot < TEST_LENGTH); n++) {
+        g_test_played[g_test_slot++] = (u16_t)pGpioRegs->out_ctrl;
+    }
+}
+
+/* The level of a pin at a time slot, straight from its timeline */
+static u8_t _test_level(const gpio_wave_pin_t *pPin, u32_t slot)
+{
+    u8_t level = pPin->initial;
+
+    for (u16_t e = 0u; (e < pPin->num) && (pPin->pEdges[e].slot <= slot); e++) {
+        level = pPin->pEdges[e].level;
+    }
+    return level;
+}
+
+/* Play random timelines on port C and compare every slot with the timelines, the pins outside the wave keep their level */
+static void _test_wave_replay(void)
+{
+    static const gpio_pin_t pins[TEST_PINS] = {BS_GPIO_PIN_0, BS_GPIO_PIN_9, BS_GPIO_PIN_15};
+    gpio_wave_edge_t edges[TEST_PINS][TEST_EDGES];
+    gpio_wave_pin_t wave[TEST_PINS];
+    gpio_wave_step_t steps[TEST_PINS * TEST_EDGES + 1u];
+    u32_t words[TEST_LENGTH];
+    u32_t state = 0x1234567u;
+
+    for (u32_t trial = 0u; trial < 200u; trial++) {
+        for (u32_t i = 0u; i < TEST_PINS; i++) {
+            u32_t slot = 0u;
+            for (u32_t e = 0u; e < TEST_EDGES; e++) {
+                slot += bs_test_random(&state) % 12u;
+                edges[i][e].slot = slot;
+                edges[i][e].level = (u8_t)(bs_test_random(&state) & 1u);
+            }
+            wave[i] = (gpio_wave_pin_t){pins[i], (u8_t)(bs_test_random(&state) & 1u), TEST_EDGES, edges[i]};
+        }
+
+        u32_t step_num = DIMOF(steps);
+        BS_TEST_CHECK(gpio_wave_compile(wave, TEST_PINS, TEST_LENGTH, steps, &step_num) == 0u);
+        u32_t word_num = DIMOF(words);
+        BS_TEST_CHECK(gpio_wave_expand(steps, step_num, words, &word_num) == 0u);
+        BS_TEST_CHECK(word_num == TEST_LENGTH);
+
+        gpio_regs_t *pGpioRegs = bs_host_gpio_regs(BS_GPIO_PORT_C);
+        u16_t others = (u16_t)bs_test_random(&state) & (u16_t)~(SET_BIT(pins[0]) | SET_BIT(pins[1]) | SET_BIT(pins[2]));
+        pGpioRegs->out_ctrl = others;
+        g_test_slot = 0u;
+        BS_TEST_CHECK(gpio_wave_play(BS_GPIO_PORT_C, steps, step_num, _test_wait) == 0u);
+        BS_TEST_CHECK(g_test_slot == TEST_LENGTH);
+
+        for (u32_t slot = 0u; slot < TEST_LENGTH; slot++) {
+            u16_t expected = others;
+            for (u32_t i = 0u; i < TEST_PINS; i++) {
+                expected |= _test_level(&wave[i], slot) ? (u16_t)SET_BIT(pins[i]) : 0u;
+            }
+            BS_TEST_CHECK(g_test_played[slot] == expected);
+            BS_TEST_CHECK((u16_t)words[slot] == (expected & (u16_t)~others));
+        }
+    }
+}
+
+/* The pins are checked before they are shifted, a pin number beyond the port is rejected like a duplicated pin */
+static void _test_wave_pins(void)
+{
+    static const gpio_wave_edge_t edge = {1u, 1u};
+    gpio_wave_pin_t wave[2] = {{BS_GPIO_PIN_3, 0u, 1u, &edge}, {BS_GPIO_PIN_3, 0u, 1u, &edge}};
+    gpio_wave_step_t steps[4];
+    u32_t step_num = DIMOF(steps);
+
+    BS_TEST_CHECK(gpio_wave_compile(wave, 2u, 8u, steps, &step_num) == RESULT_INVALID_PIN);
+    wave[1].pin = 200u;
+    BS_TEST_CHECK(gpio_wave_compile(wave, 2u, 8u, steps, &step_num) == RESULT_INVALID_PIN);
+    wave[1].pin = BS_GPIO_PIN_NUM;
+    BS_TEST_CHECK(gpio_wave_compile(wave, 2u, 8u, steps, &step_num) == RESULT_INVALID_PIN);
+    wave[1].pin = BS_GPIO_PIN_4;
+    BS_TEST_CHECK(gpio_wave_compile(wave, 2u, 8u, steps, &step_num) == 0u);
+    BS_TEST_CHECK((step_num == 2u) && (steps[0].bit_op == 0x00180000u) && (steps[1].bit_op == 0x00000018u));
+    BS_TEST_CHECK((steps[0].slots == 1u) && (steps[1].slots == 7u));
+
+    step_num = 1u;
+    BS_TEST_CHECK(gpio_wave_compile(wave, 2u, 8u, steps, &step_num) == RESULT_NO_SPACE);
+}
+
+int main(void)
+{
+    bs_host_gpio_reset();
+    _test_wave_replay();
+    _test_wave_pins();
+
+    printf("test_gpio_wave: ok\n");
+    return 0;
+}